@@ -1,24 +1,89 @@
 #include "app.hpp"
 
 #include <memory>
+#include <format>
+#include <filesystem>
+#include <vector>
 
 #include "ui/main_window.hpp"
 #include "render/renderer.hpp"
 #include "scene/scene.hpp"
+#include "scene/scene_snapshot.hpp"
+#include "scene/transform_kernel.hpp"
+#include "jobs/job_system.hpp"
+#include "services/file_service.hpp"
+#include "logger.hpp"
+#include "utility/config.hpp"
+#include "utility/messages.hpp"
+#include "utility/paths.hpp"
 
 namespace tv {
-    App::App()
+    App::App(bool headless)
     {
-        auto& mainWindow = tv::ui::MainWindow::instance();
         auto& renderer = tv::Renderer::instance();
         std::unique_ptr<Scene> scene = std::make_unique<Scene>();
+        if (headless) {
+            tv::Renderer::setupHeadless(renderer, vk::Extent2D{ constants::config::WINDOW_MAIN_WIDTH, constants::config::WINDOW_MAIN_HEIGHT });
+            runHeadless(renderer, scene.get());
+            return;
+        }
+
+        auto& mainWindow = tv::ui::MainWindow::instance();
         tv::Renderer::setup(renderer, mainWindow.getWindow());
+#if(TV_JOB_BENCHMARK)
+        JobSystem::instance().benchmark();
+#endif
+#if(TV_TRANSFORM_BENCHMARK)
+        benchmarkModelMatrices();
+#endif
+#if(TV_RECORDING_BENCHMARK)
+        {
+            Scene benchmarkScene{ constants::config::RECORDING_BENCHMARK_INSTANCE_COUNT };
+            SceneSnapshot benchmarkSnapshot{};
+            benchmarkSnapshot.extract(benchmarkScene);
+            renderer.benchmarkRecording(&benchmarkSnapshot);
+        }
+#endif
 
         mainWindow.processEvents(renderer, scene.get());
     }
 
-    App& App::instance() noexcept {
-        static App instance;
+    App& App::instance(bool headless) noexcept {
+        static App instance{ headless };
         return instance;
     }
+
+    void App::runHeadless(Renderer& renderer, Scene* scene) const noexcept {
+        auto& logger = Logger::instance();
+        SceneSnapshot snapshot{};
+        for (std::size_t i = 0; i < constants::config::HEADLESS_FRAME_COUNT; ++i) {
+            scene->updateWorldTransforms();
+            snapshot.extract(*scene);
+            renderer.render(&snapshot);
+        }
+
+        const structures::VHostFrame frame = renderer.getLastFrame();
+        logger.log(std::format("{}: {}\n", constants::messages::HEADLESS_FRAMES_RENDERED, constants::config::HEADLESS_FRAME_COUNT));
+        logger.log(std::format("{}: {}\n", constants::messages::HEADLESS_VISIBLE_INSTANCES, renderer.getVisibleInstanceCount()));
+        if (!frame.pixels)
+            return;
+
+        // binary PPM, B8G8R8A8 swizzled to RGB
+        std::vector<char> image{};
+        const std::string header = std::format("P6\n{} {}\n255\n", frame.extent.width, frame.extent.height);
+        image.reserve(header.size() + static_cast<std::size_t>(frame.extent.width) * frame.extent.height * 3);
+        image.assign(header.begin(), header.end());
+        for (uint32_t y = 0; y < frame.extent.height; ++y) {
+            const uint8_t* row = frame.pixels + y * frame.rowPitch;
+            for (uint32_t x = 0; x < frame.extent.width; ++x) {
+                image.push_back(static_cast<char>(row[x * 4 + 2]));
+                image.push_back(static_cast<char>(row[x * 4 + 1]));
+                image.push_back(static_cast<char>(row[x * 4 + 0]));
+            }
+        }
+
+        const std::filesystem::path framePath = service::FileService::getExecutableDirectory() / constants::path::HEADLESS_FRAME_FILE;
+        if (service::FileService::writeAtomically(framePath.string(), image))
+            logger.log(std::format("{}: {}\n", constants::messages::HEADLESS_FRAME_WRITTEN, framePath.string()));
+    }
 }
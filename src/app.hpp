@@ -3,15 +3,20 @@
 #include "utility/types.hpp"
 
 namespace tv {
+    class Renderer;
+    class Scene;
+
     class App {
     public:
         TV_NCM(App)
 
-        static App& instance() noexcept;
+        static App& instance(bool headless = false) noexcept;
 
     private:
-        App();
+        explicit App(bool headless);
 
         ~App() = default;
+
+        void runHeadless(Renderer& renderer, Scene* scene) const noexcept;
     };
 }
@@ -0,0 +1,288 @@
+#include "job_system.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <limits>
+
+#include "../logger.hpp"
+#include "../utility/config.hpp"
+#include "../utility/messages.hpp"
+
+namespace tv {
+    namespace {
+        constexpr std::size_t noWorker = std::numeric_limits<std::size_t>::max();
+
+        thread_local std::size_t currentWorker = noWorker;
+
+        std::atomic<std::size_t> requestedWorkerCount = 0;
+    }
+
+    JobCounter::JobCounter() noexcept
+        : _state{ 0 }
+    {}
+
+    bool JobCounter::done() const noexcept {
+        return _state.load(std::memory_order_acquire) == 0;
+    }
+
+    JobSystem::Worker::Worker(std::size_t capacity) noexcept
+        : deque{ capacity }
+    {}
+
+    JobSystem::JobSystem() noexcept
+        : _injectedCount{ 0 },
+          _wakeEpoch{ 0 },
+          _sleeping{ 0 }
+    {
+        const std::size_t requested = requestedWorkerCount.load(std::memory_order_relaxed);
+        const std::size_t workerCount = std::max<std::size_t>(1, requested > 0 ? requested : std::thread::hardware_concurrency());
+        _workers.reserve(workerCount);
+        for (std::size_t i = 0; i < workerCount; ++i)
+            _workers.push_back(std::make_unique<Worker>(constants::config::JOB_QUEUE_CAPACITY));
+
+        currentWorker = 0;
+        _threads.reserve(workerCount - 1);
+        for (std::size_t i = 1; i < workerCount; ++i)
+            _threads.emplace_back([this, i](std::stop_token stopToken) { workerLoop(stopToken, i); });
+    }
+
+    JobSystem::~JobSystem() {
+        for (auto& thread : _threads)
+            thread.request_stop();
+
+        _wakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+        _wakeEpoch.notify_all();
+
+        // join before the deques go away
+        for (auto& thread : _threads)
+            thread.join();
+    }
+
+    JobSystem& JobSystem::instance() noexcept {
+        static JobSystem instance{};
+        return instance;
+    }
+
+    void JobSystem::setWorkerCount(std::size_t workerCount) noexcept {
+        requestedWorkerCount.store(workerCount, std::memory_order_relaxed);
+    }
+
+    std::size_t JobSystem::getWorkerCount() const noexcept {
+        return _workers.size();
+    }
+
+    void JobSystem::run(Job job, JobCounter& counter) noexcept {
+        job.counter = &counter;
+        counter._state.fetch_add(1, std::memory_order_relaxed);
+        submit(job);
+    }
+
+    void JobSystem::runAfter(JobCounter& dependency, Job job, JobCounter& counter) noexcept {
+        job.counter = &counter;
+        counter._state.fetch_add(1, std::memory_order_relaxed);
+        {
+            // the last job of the dependency takes this lock before handing out continuations
+            std::scoped_lock lock{ dependency._mutex };
+            // a releasing dependency has already swapped its continuations out, so only pending jobs count
+            if ((dependency._state.load(std::memory_order_acquire) & (JobCounter::releasing - 1)) != 0) {
+                dependency._continuations.push_back(job);
+                return;
+            }
+        }
+
+        submit(job);
+    }
+
+    void JobSystem::wait(JobCounter& counter) noexcept {
+        Job job{};
+        std::size_t idle = 0;
+        while (!counter.done()) {
+            if (findJob(currentWorker, job)) {
+                execute(job);
+                idle = 0;
+            } else if (++idle > constants::config::JOB_SPIN_COUNT) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::submit(const Job& job) noexcept {
+        if (currentWorker == noWorker) {
+            {
+                std::scoped_lock lock{ _injectedMutex };
+                _injected.push_back(job);
+            }
+            _injectedCount.fetch_add(1, std::memory_order_release);
+            wake();
+            return;
+        }
+
+        if (!_workers[currentWorker]->deque.push(job)) {
+            // a full deque means plenty of parallel work already, running inline keeps the order bounded
+            execute(job);
+            return;
+        }
+
+        wake();
+    }
+
+    bool JobSystem::findJob(std::size_t workerIndex, Job& job) noexcept {
+        if (workerIndex != noWorker && _workers[workerIndex]->deque.pop(job))
+            return true;
+
+        if (_injectedCount.load(std::memory_order_acquire) > 0) {
+            std::scoped_lock lock{ _injectedMutex };
+            if (!_injected.empty()) {
+                job = _injected.front();
+                _injected.pop_front();
+                _injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // start past ourselves so thieves spread over the victims
+        const std::size_t workerCount = _workers.size();
+        const std::size_t start = workerIndex == noWorker ? 0 : workerIndex + 1;
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            const std::size_t victim = (start + i) % workerCount;
+            if (victim == workerIndex)
+                continue;
+
+            if (_workers[victim]->deque.steal(job))
+                return true;
+        }
+
+        return false;
+    }
+
+    void JobSystem::execute(const Job& job) noexcept {
+        job.function(job.data, job.begin, job.end);
+        finish(*job.counter);
+    }
+
+    void JobSystem::finish(JobCounter& counter) noexcept {
+        uint64_t state = counter._state.load(std::memory_order_relaxed);
+        bool last = false;
+        do {
+            // the last job raises the releasing bit instead of dropping to zero, so waiters
+            // cannot see the counter done and destroy it while continuations are handed out
+            last = state == 1;
+        } while (!counter._state.compare_exchange_weak(state, last ? JobCounter::releasing : state - 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        if (!last)
+            return;
+
+        std::vector<Job> continuations;
+        {
+            std::scoped_lock lock{ counter._mutex };
+            continuations.swap(counter._continuations);
+        }
+
+        counter._state.fetch_sub(JobCounter::releasing, std::memory_order_acq_rel);
+
+        for (const Job& continuation : continuations)
+            submit(continuation);
+    }
+
+    void JobSystem::wake() noexcept {
+        // pairs with the fence in workerLoop, either the sleeper sees the new job or we see the sleeper
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_sleeping.load(std::memory_order_relaxed) == 0)
+            return;
+
+        _wakeEpoch.fetch_add(1, std::memory_order_relaxed);
+        _wakeEpoch.notify_one();
+    }
+
+    void JobSystem::workerLoop(std::stop_token stopToken, std::size_t workerIndex) noexcept {
+        currentWorker = workerIndex;
+
+        Job job{};
+        std::size_t idle = 0;
+        while (!stopToken.stop_requested()) {
+            if (findJob(workerIndex, job)) {
+                execute(job);
+                idle = 0;
+                continue;
+            }
+
+            if (++idle <= constants::config::JOB_SPIN_COUNT) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const uint32_t epoch = _wakeEpoch.load(std::memory_order_relaxed);
+            _sleeping.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (findJob(workerIndex, job)) {
+                _sleeping.fetch_sub(1, std::memory_order_relaxed);
+                execute(job);
+                idle = 0;
+                continue;
+            }
+
+            if (!stopToken.stop_requested())
+                _wakeEpoch.wait(epoch, std::memory_order_relaxed);
+            _sleeping.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    void JobSystem::benchmark() noexcept {
+        constexpr std::size_t jobCount = constants::config::JOB_BENCHMARK_JOB_COUNT;
+        constexpr std::size_t iterations = constants::config::JOB_BENCHMARK_ITERATIONS;
+
+        // empty jobs, so the time is all queueing, stealing and counting
+        {
+            JobCounter counter;
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                for (std::size_t j = 0; j < jobCount; ++j)
+                    run(Job{ [](void*, std::size_t, std::size_t) {}, nullptr, 0, 0, nullptr }, counter);
+                wait(counter);
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            Logger::instance().log(std::format(
+                "{}: {} jobs, {} workers: {:.1f} ns per job\n",
+                constants::messages::JOB_BENCHMARK_OVERHEAD,
+                jobCount,
+                getWorkerCount(),
+                elapsed.count() / static_cast<double>(iterations * jobCount)
+            ));
+        }
+
+        constexpr std::size_t itemCount = constants::config::JOB_BENCHMARK_ITEM_COUNT;
+        std::vector<float> items(itemCount);
+        std::vector<std::size_t> jobCounts;
+        for (std::size_t count = 1; count < getWorkerCount(); count *= 2)
+            jobCounts.push_back(count);
+        jobCounts.push_back(getWorkerCount());
+
+        double baseline = 0.0;
+        for (const std::size_t count : jobCounts) {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                parallelFor(itemCount, (itemCount + count - 1) / count, [&items](std::size_t begin, std::size_t end) {
+                    for (std::size_t item = begin; item < end; ++item)
+                        items[item] = std::sqrt(static_cast<float>(item)) * std::sin(static_cast<float>(item));
+                });
+            }
+
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            const double milliseconds = elapsed.count() / iterations;
+            if (count == 1)
+                baseline = milliseconds;
+
+            Logger::instance().log(std::format(
+                "{}: {} items, {} jobs: {:.3f} ms, {:.2f}x\n",
+                constants::messages::JOB_BENCHMARK_SCALING,
+                itemCount,
+                count,
+                milliseconds,
+                baseline / milliseconds
+            ));
+        }
+    }
+}
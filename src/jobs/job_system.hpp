@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "work_stealing_deque.hpp"
+#include "../utility/types.hpp"
+
+namespace tv {
+    class JobCounter;
+
+    using JobFunction = void (*)(void* data, std::size_t begin, std::size_t end);
+
+    // a range of work; data has to outlive the counter the job is run on
+    struct Job {
+        JobFunction function;
+        void* data;
+        std::size_t begin;
+        std::size_t end;
+        JobCounter* counter;
+    };
+
+    // tracks the unfinished jobs run on it; jobs scheduled after a counter start once it drops to zero.
+    // A counter may be reused once waited on
+    class JobCounter {
+    public:
+        TV_NCM(JobCounter)
+
+        JobCounter() noexcept;
+
+        ~JobCounter() = default;
+
+        [[nodiscard]] bool done() const noexcept;
+
+    private:
+        friend class JobSystem;
+
+        // low bits count pending jobs, the releasing bit is held while the last job hands out continuations
+        static constexpr uint64_t releasing = uint64_t{ 1 } << 32;
+
+        std::atomic<uint64_t> _state;
+        std::mutex _mutex;
+        std::vector<Job> _continuations;
+    };
+
+    // fixed worker pool with a deque per thread: a thread runs its own jobs newest first
+    // and steals the oldest ones of others once it runs dry. The thread that first
+    // touches the instance becomes worker 0 and only runs jobs while waiting
+    class JobSystem {
+    public:
+        TV_NCM(JobSystem)
+
+        static JobSystem& instance() noexcept;
+        // worker count of the instance, only taken when it is created; 0 means one per hardware thread
+        static void setWorkerCount(std::size_t workerCount) noexcept;
+
+        // including the owning thread
+        [[nodiscard]] std::size_t getWorkerCount() const noexcept;
+
+        void run(Job job, JobCounter& counter) noexcept;
+        // starts once dependency is done
+        void runAfter(JobCounter& dependency, Job job, JobCounter& counter) noexcept;
+        // runs queued jobs until the counter is done
+        void wait(JobCounter& counter) noexcept;
+
+        // calls f(begin, end) over [0, count) in ranges of at most grain, the caller takes the first one
+        template<typename F>
+        void parallelFor(std::size_t count, std::size_t grain, F&& f) noexcept {
+            using Function = std::remove_reference_t<F>;
+            grain = std::max<std::size_t>(grain, 1);
+            if (count <= grain) {
+                if (count > 0)
+                    f(std::size_t{ 0 }, count);
+                return;
+            }
+
+            JobCounter counter;
+            for (std::size_t begin = grain; begin < count; begin += grain) {
+                run(Job{
+                    [](void* data, std::size_t first, std::size_t last) { (*static_cast<Function*>(data))(first, last); },
+                    const_cast<void*>(static_cast<const void*>(std::addressof(f))),
+                    begin,
+                    std::min(begin + grain, count),
+                    nullptr
+                }, counter);
+            }
+
+            f(std::size_t{ 0 }, grain);
+            wait(counter);
+        }
+
+        void benchmark() noexcept;
+
+    private:
+        struct alignas(64) Worker {
+            explicit Worker(std::size_t capacity) noexcept;
+
+            WorkStealingDeque<Job> deque;
+        };
+
+        JobSystem() noexcept;
+
+        ~JobSystem();
+
+        void submit(const Job& job) noexcept;
+        [[nodiscard]] bool findJob(std::size_t workerIndex, Job& job) noexcept;
+        void execute(const Job& job) noexcept;
+        void finish(JobCounter& counter) noexcept;
+        void wake() noexcept;
+        void workerLoop(std::stop_token stopToken, std::size_t workerIndex) noexcept;
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::vector<std::jthread> _threads;
+        // jobs submitted from threads outside the pool
+        std::mutex _injectedMutex;
+        std::deque<Job> _injected;
+        std::atomic<std::size_t> _injectedCount;
+        // sleepers wait for the epoch to move, submitters only bump it when someone sleeps
+        std::atomic<uint32_t> _wakeEpoch;
+        std::atomic<uint32_t> _sleeping;
+    };
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include "../utility/types.hpp"
+
+namespace tv {
+    // fixed-capacity Chase-Lev deque: the owning thread pushes and pops at the bottom,
+    // any other thread steals from the top. Orderings follow Le et al., "Correct and Efficient
+    // Work-Stealing for Weak Memory Models".
+    // Items are held by value in atomic words: a thief that lost its race may read a slot the owner
+    // is refilling, the copy is thrown away when its CAS fails but the read itself must not race
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    class WorkStealingDeque {
+    public:
+        TV_NCM(WorkStealingDeque)
+
+        explicit WorkStealingDeque(std::size_t capacity) noexcept
+            : _mask{ static_cast<int64_t>(std::bit_ceil(capacity)) - 1 },
+              _slots{ std::make_unique<Slot[]>(static_cast<std::size_t>(_mask) + 1) },
+              _top{ 0 },
+              _bottom{ 0 }
+        {}
+
+        ~WorkStealingDeque() = default;
+
+        // owner only, fails when full
+        bool push(const T& item) noexcept {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+            const int64_t top = _top.load(std::memory_order_acquire);
+            if (bottom - top > _mask)
+                return false;
+
+            store(_slots[bottom & _mask], item);
+            std::atomic_thread_fence(std::memory_order_release);
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // owner only, newest first
+        bool pop(T& item) noexcept {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            _bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = _top.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            load(_slots[bottom & _mask], item);
+            if (top == bottom) {
+                // the last item, race the thieves for it
+                const bool won = _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return won;
+            }
+
+            return true;
+        }
+
+        // any thread, oldest first; fails when empty or when another thief won
+        bool steal(T& item) noexcept {
+            int64_t top = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = _bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+                return false;
+
+            // copy before the CAS: once top moves past the slot the owner may refill it
+            T stolen;
+            load(_slots[top & _mask], stolen);
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return false;
+
+            item = stolen;
+            return true;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _top.load(std::memory_order_relaxed) >= _bottom.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::size_t getCapacity() const noexcept {
+            return static_cast<std::size_t>(_mask) + 1;
+        }
+
+    private:
+        using Word = std::uintptr_t;
+
+        static constexpr std::size_t wordCount = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+        struct Slot {
+            std::atomic<Word> words[wordCount];
+        };
+
+        static void store(Slot& slot, const T& item) noexcept {
+            Word words[wordCount]{};
+            std::memcpy(words, &item, sizeof(T));
+            for (std::size_t i = 0; i < wordCount; ++i)
+                slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        static void load(const Slot& slot, T& item) noexcept {
+            Word words[wordCount];
+            for (std::size_t i = 0; i < wordCount; ++i)
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            std::memcpy(&item, words, sizeof(T));
+        }
+
+        const int64_t _mask;
+        std::unique_ptr<Slot[]> _slots;
+        // on separate lines, thieves hammer the top while the owner works the bottom
+        alignas(64) std::atomic<int64_t> _top;
+        alignas(64) std::atomic<int64_t> _bottom;
+    };
+}
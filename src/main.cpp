@@ -1,7 +1,12 @@
 #include "app.hpp"
 
-int main() {
-    tv::App::instance();
+#include <string_view>
+
+#include "utility/config.hpp"
+
+int main(int argc, char* argv[]) {
+    const bool headless = argc > 1 && std::string_view{ argv[1] } == tv::constants::config::HEADLESS_ARGUMENT;
+    tv::App::instance(headless);
 
     return 0;
 }
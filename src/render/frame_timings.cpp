@@ -0,0 +1,50 @@
+#include "frame_timings.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+namespace tv {
+    FrameTimings::FrameTimings(std::size_t capacity) noexcept
+        : _timings(std::max<std::size_t>(1, capacity)),
+          _next{ 0 },
+          _count{ 0 }
+    {}
+
+    void FrameTimings::push(const FrameTiming& timing) noexcept {
+        _timings[_next] = timing;
+        _next = (_next + 1) % _timings.size();
+        _count = std::min(_count + 1, _timings.size());
+    }
+
+    std::size_t FrameTimings::getCount() const noexcept {
+        return _count;
+    }
+
+    const FrameTiming& FrameTimings::getLatest() const noexcept {
+        assert(_count > 0);
+        return _timings[(_next + _timings.size() - 1) % _timings.size()];
+    }
+
+    FrameTimingStats FrameTimings::getStats(double FrameTiming::* field) const noexcept {
+        if (_count == 0)
+            return {};
+
+        // the oldest entries are overwritten first, so the first _count slots are always the live ones
+        std::vector<double> values(_count);
+        std::ranges::transform(_timings.begin(), _timings.begin() + static_cast<std::ptrdiff_t>(_count), values.begin(), [field](const FrameTiming& timing) {
+            return timing.*field;
+        });
+
+        FrameTimingStats stats;
+        stats.min = std::ranges::min(values);
+        stats.avg = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+
+        const auto p99Index = static_cast<std::size_t>(std::ceil(0.99 * static_cast<double>(values.size()))) - 1;
+        std::ranges::nth_element(values, values.begin() + static_cast<std::ptrdiff_t>(p99Index));
+        stats.p99 = values[p99Index];
+
+        return stats;
+    }
+}
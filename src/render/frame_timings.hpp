@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../utility/types.hpp"
+
+namespace tv {
+    // all durations in milliseconds
+    struct FrameTiming {
+        double frame;
+        double frameWait;
+        double acquire;
+        double cull;
+        double record;
+        double submit;
+        double present;
+        double gpu;
+    };
+
+    struct FrameTimingStats {
+        double min;
+        double avg;
+        double p99;
+    };
+
+    class FrameTimings {
+    public:
+        TV_NCM(FrameTimings)
+
+        explicit FrameTimings(std::size_t capacity) noexcept;
+
+        ~FrameTimings() = default;
+
+        void push(const FrameTiming& timing) noexcept;
+        [[nodiscard]] std::size_t getCount() const noexcept;
+        [[nodiscard]] const FrameTiming& getLatest() const noexcept;
+        [[nodiscard]] FrameTimingStats getStats(double FrameTiming::* field) const noexcept;
+
+    private:
+        std::vector<FrameTiming> _timings;
+        std::size_t _next;
+        std::size_t _count;
+    };
+}
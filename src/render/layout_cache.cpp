@@ -0,0 +1,221 @@
+#include "layout_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+
+#include "../logger.hpp"
+#include "../utility/messages.hpp"
+
+namespace tv {
+    namespace {
+        static_assert(static_cast<uint32_t>(vk::DescriptorType::eSampler) == static_cast<uint32_t>(shader::DescriptorKind::sampler));
+        static_assert(static_cast<uint32_t>(vk::DescriptorType::eStorageBuffer) == static_cast<uint32_t>(shader::DescriptorKind::storageBuffer));
+
+        vk::ShaderStageFlags stageFlags(shader::ShaderStage stage) noexcept {
+            switch (stage) {
+                case shader::ShaderStage::vertex:
+                    return vk::ShaderStageFlagBits::eVertex;
+                case shader::ShaderStage::fragment:
+                    return vk::ShaderStageFlagBits::eFragment;
+                case shader::ShaderStage::compute:
+                    return vk::ShaderStageFlagBits::eCompute;
+            }
+
+            return {};
+        }
+
+        // 32-bit components cover every input the shaders declare, anything else has no format
+        vk::Format vertexFormat(const shader::VertexInput& input) noexcept {
+            if (input.componentSize != sizeof(uint32_t) || input.componentCount == 0 || input.componentCount > 4)
+                return vk::Format::eUndefined;
+
+            constexpr std::array<vk::Format, 4> floatFormats = {
+                vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat
+            };
+            constexpr std::array<vk::Format, 4> signedFormats = {
+                vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint, vk::Format::eR32G32B32A32Sint
+            };
+            constexpr std::array<vk::Format, 4> unsignedFormats = {
+                vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint, vk::Format::eR32G32B32A32Uint
+            };
+
+            switch (input.type) {
+                case shader::ComponentType::floatingPoint:
+                    return floatFormats[input.componentCount - 1];
+                case shader::ComponentType::signedInteger:
+                    return signedFormats[input.componentCount - 1];
+                case shader::ComponentType::unsignedInteger:
+                    return unsignedFormats[input.componentCount - 1];
+            }
+
+            return vk::Format::eUndefined;
+        }
+
+        void describeBindings(std::vector<uint32_t>& key, const std::vector<vk::DescriptorSetLayoutBinding>& vBindings) noexcept {
+            key.push_back(static_cast<uint32_t>(vBindings.size()));
+            for (const vk::DescriptorSetLayoutBinding& vBinding : vBindings) {
+                key.push_back(vBinding.binding);
+                key.push_back(static_cast<uint32_t>(vBinding.descriptorType));
+                key.push_back(vBinding.descriptorCount);
+                key.push_back(static_cast<uint32_t>(vBinding.stageFlags));
+            }
+        }
+    }
+
+    LayoutCache::LayoutCache(vk::Device vDevice) noexcept
+        : _vDevice{ vDevice }
+    {}
+
+    LayoutCache::~LayoutCache() {
+        for (const auto& layout : _layouts)
+            _vDevice.destroyPipelineLayout(layout.second.layout);
+
+        for (const auto& setLayout : _setLayouts)
+            _vDevice.destroyDescriptorSetLayout(setLayout.second);
+    }
+
+    ReflectedLayout LayoutCache::getLayout(std::span<const shader::Reflection> stages) noexcept {
+        std::vector<std::vector<vk::DescriptorSetLayoutBinding>> sets;
+        std::vector<vk::PushConstantRange> pushConstantRanges;
+        for (const shader::Reflection& stage : stages) {
+            const vk::ShaderStageFlags vStage = stageFlags(stage.stage);
+            // one range per stage, all starting at zero, so each stage may read the whole block
+            if (stage.pushConstantSize > 0) {
+                vk::PushConstantRange pushConstantRange;
+                pushConstantRange.offset = 0;
+                pushConstantRange.size = stage.pushConstantSize;
+                pushConstantRange.stageFlags = vStage;
+                pushConstantRanges.push_back(pushConstantRange);
+            }
+
+            for (const shader::DescriptorBinding& binding : stage.bindings) {
+                if (sets.size() <= binding.set)
+                    sets.resize(binding.set + 1);
+
+                // a binding several stages read is declared once with all of them
+                std::vector<vk::DescriptorSetLayoutBinding>& vBindings = sets[binding.set];
+                const auto existing = std::ranges::find(vBindings, binding.binding, &vk::DescriptorSetLayoutBinding::binding);
+                if (existing != vBindings.end()) {
+                    existing->stageFlags |= vStage;
+                    continue;
+                }
+
+                vk::DescriptorSetLayoutBinding vBinding{};
+                vBinding.binding = binding.binding;
+                vBinding.descriptorType = static_cast<vk::DescriptorType>(binding.kind);
+                // runtime-sized arrays need descriptor indexing, which the device is not created with
+                vBinding.descriptorCount = std::max(binding.count, 1u);
+                vBinding.stageFlags = vStage;
+                vBindings.push_back(vBinding);
+            }
+        }
+
+        Key key;
+        for (std::vector<vk::DescriptorSetLayoutBinding>& vBindings : sets) {
+            std::ranges::sort(vBindings, {}, &vk::DescriptorSetLayoutBinding::binding);
+            describeBindings(key, vBindings);
+        }
+        key.push_back(static_cast<uint32_t>(pushConstantRanges.size()));
+        for (const vk::PushConstantRange& pushConstantRange : pushConstantRanges) {
+            key.push_back(static_cast<uint32_t>(pushConstantRange.stageFlags));
+            key.push_back(pushConstantRange.size);
+        }
+
+        if (const auto cached = _layouts.find(key); cached != _layouts.end())
+            return cached->second;
+
+        ReflectedLayout reflectedLayout{};
+        for (const std::vector<vk::DescriptorSetLayoutBinding>& vBindings : sets) {
+            const vk::DescriptorSetLayout vSetLayout = getSetLayout(vBindings);
+            if (!vSetLayout)
+                return {};
+
+            reflectedLayout.setLayouts.push_back(vSetLayout);
+        }
+
+        vk::PipelineLayoutCreateInfo layoutInfo;
+        layoutInfo.flags = vk::PipelineLayoutCreateFlags();
+        layoutInfo.setLayoutCount = static_cast<uint32_t>(reflectedLayout.setLayouts.size());
+        layoutInfo.pSetLayouts = reflectedLayout.setLayouts.data();
+        layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+        layoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+        try {
+            reflectedLayout.layout = _vDevice.createPipelineLayout(layoutInfo);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_PIPELINE_LAYOUT_CREATION_FAILED, err.what()));
+#endif
+            return {};
+        }
+
+        _layouts.emplace(std::move(key), reflectedLayout);
+        return reflectedLayout;
+    }
+
+    ReflectedVertexInput LayoutCache::getVertexInput(const shader::Reflection& vertexStage) noexcept {
+        ReflectedVertexInput vertexInput{};
+        uint32_t stride = 0;
+        for (const shader::VertexInput& input : vertexStage.inputs) {
+            const vk::Format vFormat = vertexFormat(input);
+            if (vFormat == vk::Format::eUndefined)
+                continue;
+
+            vk::VertexInputAttributeDescription attribute{};
+            attribute.location = input.location;
+            attribute.binding = 0;
+            attribute.format = vFormat;
+            attribute.offset = stride;
+            vertexInput.attributes.push_back(attribute);
+
+            stride += input.componentSize * input.componentCount;
+        }
+
+        if (vertexInput.attributes.empty())
+            return vertexInput;
+
+        vk::VertexInputBindingDescription binding{};
+        binding.binding = 0;
+        binding.stride = stride;
+        binding.inputRate = vk::VertexInputRate::eVertex;
+        vertexInput.bindings.push_back(binding);
+
+        return vertexInput;
+    }
+
+    std::size_t LayoutCache::KeyHash::operator()(const Key& key) const noexcept {
+        // FNV-1a over the words, keys are a few dozen of them
+        uint64_t result = 0xcbf29ce484222325ull;
+        for (const uint32_t word : key) {
+            result ^= word;
+            result *= 0x100000001b3ull;
+        }
+
+        return static_cast<std::size_t>(result);
+    }
+
+    vk::DescriptorSetLayout LayoutCache::getSetLayout(const std::vector<vk::DescriptorSetLayoutBinding>& vBindings) noexcept {
+        Key key;
+        describeBindings(key, vBindings);
+        if (const auto cached = _setLayouts.find(key); cached != _setLayouts.end())
+            return cached->second;
+
+        vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.flags = vk::DescriptorSetLayoutCreateFlags();
+        layoutInfo.bindingCount = static_cast<uint32_t>(vBindings.size());
+        layoutInfo.pBindings = vBindings.data();
+
+        try {
+            const vk::DescriptorSetLayout vSetLayout = _vDevice.createDescriptorSetLayout(layoutInfo);
+            _setLayouts.emplace(std::move(key), vSetLayout);
+            return vSetLayout;
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_DESCRIPTOR_SET_LAYOUT_CREATION_FAILED, err.what()));
+#endif
+        }
+
+        return nullptr;
+    }
+}
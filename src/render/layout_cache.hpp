@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "../shaders/reflection.hpp"
+#include "../utility/types.hpp"
+
+namespace tv {
+    // layouts of a pipeline, owned by the layout cache
+    struct ReflectedLayout {
+        // indexed by set number, sets no stage uses get an empty layout
+        std::vector<vk::DescriptorSetLayout> setLayouts;
+        vk::PipelineLayout layout;
+    };
+
+    // a single interleaved binding for a vertex shader's inputs, empty when it has none
+    struct ReflectedVertexInput {
+        std::vector<vk::VertexInputBindingDescription> bindings;
+        std::vector<vk::VertexInputAttributeDescription> attributes;
+    };
+
+    // descriptor set and pipeline layouts derived from shader reflection instead of written by hand.
+    // Layouts are keyed by a description of their contents, so pipelines with the same interface share
+    // one Vulkan object however many of them are created
+    class LayoutCache {
+    public:
+        TV_NCM(LayoutCache)
+
+        explicit LayoutCache(vk::Device vDevice) noexcept;
+
+        ~LayoutCache();
+
+        // merges the stages' descriptor bindings and push constants, null layouts if creation fails;
+        // called on the render thread while pipelines are requested
+        [[nodiscard]] ReflectedLayout getLayout(std::span<const shader::Reflection> stages) noexcept;
+
+        [[nodiscard]] static ReflectedVertexInput getVertexInput(const shader::Reflection& vertexStage) noexcept;
+
+    private:
+        using Key = std::vector<uint32_t>;
+
+        struct KeyHash {
+            [[nodiscard]] std::size_t operator()(const Key& key) const noexcept;
+        };
+
+        [[nodiscard]] vk::DescriptorSetLayout getSetLayout(const std::vector<vk::DescriptorSetLayoutBinding>& vBindings) noexcept;
+
+        vk::Device _vDevice;
+        std::unordered_map<Key, vk::DescriptorSetLayout, KeyHash> _setLayouts;
+        std::unordered_map<Key, ReflectedLayout, KeyHash> _layouts;
+    };
+}
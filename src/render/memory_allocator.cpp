@@ -0,0 +1,285 @@
+#include "memory_allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <format>
+#include <limits>
+
+#include "../logger.hpp"
+#include "../utility/config.hpp"
+#include "../utility/messages.hpp"
+
+namespace tv {
+    MemoryAllocator::MemoryAllocator(const vk::PhysicalDeviceMemoryProperties& memoryProperties, vk::DeviceSize bufferImageGranularity, MemoryBlockCallbacks callbacks, vk::DeviceSize blockSize) noexcept
+        : _memoryProperties{ memoryProperties },
+          _bufferImageGranularity{ bufferImageGranularity },
+          _callbacks{ std::move(callbacks) },
+          _blockSize{ std::bit_ceil(std::max(blockSize, constants::config::VULKAN_MEMORY_MIN_ALLOCATION)) },
+          _maxOrder{ static_cast<uint32_t>(std::countr_zero(_blockSize / constants::config::VULKAN_MEMORY_MIN_ALLOCATION)) },
+          _stats{}
+    {}
+
+    MemoryAllocator::~MemoryAllocator() {
+        for (const auto& block : _blocks)
+            _callbacks.free(block->memory);
+    }
+
+    MemoryBlockCallbacks MemoryAllocator::deviceCallbacks(vk::Device vDevice) noexcept {
+        MemoryBlockCallbacks callbacks;
+        callbacks.allocate = [vDevice](uint32_t memoryTypeIndex, vk::DeviceSize size) -> vk::DeviceMemory {
+            vk::MemoryAllocateInfo allocInfo{};
+            allocInfo.allocationSize = size;
+            allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+            try {
+                return vDevice.allocateMemory(allocInfo);
+            } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_MEMORY_ALLOCATION_FAILED, err.what()));
+#endif
+            }
+
+            return nullptr;
+        };
+        callbacks.free = [vDevice](vk::DeviceMemory memory) {
+            vDevice.freeMemory(memory);
+        };
+        callbacks.map = [vDevice](vk::DeviceMemory memory, vk::DeviceSize size) -> void* {
+            try {
+                return vDevice.mapMemory(memory, 0, size);
+            } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_MEMORY_MAP_FAILED, err.what()));
+#endif
+            }
+
+            return nullptr;
+        };
+        callbacks.invalidate = [vDevice](vk::DeviceMemory memory, vk::DeviceSize offset, vk::DeviceSize size) {
+            vk::MappedMemoryRange range{};
+            range.memory = memory;
+            range.offset = offset;
+            range.size = size;
+
+            try {
+                vDevice.invalidateMappedMemoryRanges(range);
+            } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_MEMORY_INVALIDATE_FAILED, err.what()));
+#endif
+            }
+        };
+
+        return callbacks;
+    }
+
+    MemoryAllocation MemoryAllocator::allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags vProperties, AllocationTiling tiling) noexcept {
+        std::scoped_lock lock{ _mutex };
+
+        const uint32_t memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, vProperties);
+        if (memoryTypeIndex == std::numeric_limits<uint32_t>::max())
+            return {};
+
+        // buddy nodes are aligned to their own size, so covering the alignment is enough
+        const vk::DeviceSize nodeSize = std::max(requirements.size, requirements.alignment);
+        if (nodeSize > _blockSize / 2) {
+            MemoryBlock* block = createBlock(memoryTypeIndex, requirements.size, tiling, true);
+            if (!block)
+                return {};
+
+            _stats.usedBytes += requirements.size;
+            ++_stats.allocationCount;
+            return { block->memory, 0, requirements.size, block->mapped, block };
+        }
+
+        const uint32_t order = orderFor(nodeSize);
+        // with a granularity above one, linear and optimal resources never share a block
+        const bool mixTilings = _bufferImageGranularity <= 1;
+
+        vk::DeviceSize offset = 0;
+        MemoryBlock* target = nullptr;
+        for (const auto& block : _blocks) {
+            if (block->dedicated || block->memoryTypeIndex != memoryTypeIndex)
+                continue;
+
+            if (!mixTilings && block->tiling != tiling)
+                continue;
+
+            if (allocateFromBlock(*block, order, offset)) {
+                target = block.get();
+                break;
+            }
+        }
+
+        if (!target) {
+            target = createBlock(memoryTypeIndex, _blockSize, tiling, false);
+            if (!target || !allocateFromBlock(*target, order, offset))
+                return {};
+        }
+
+        _stats.usedBytes += requirements.size;
+        _stats.wastedBytes += orderSize(order) - requirements.size;
+        ++_stats.allocationCount;
+
+        return {
+            target->memory,
+            offset,
+            requirements.size,
+            target->mapped ? static_cast<char*>(target->mapped) + offset : nullptr,
+            target
+        };
+    }
+
+    void MemoryAllocator::free(MemoryAllocation& allocation) noexcept {
+        if (!allocation.block)
+            return;
+
+        std::scoped_lock lock{ _mutex };
+
+        MemoryBlock* block = allocation.block;
+        _stats.usedBytes -= allocation.size;
+        --_stats.allocationCount;
+
+        if (block->dedicated) {
+            destroyBlock(block);
+        } else {
+            assert(block->allocatedOrders.contains(allocation.offset));
+            _stats.wastedBytes -= orderSize(block->allocatedOrders[allocation.offset]) - allocation.size;
+            freeInBlock(*block, allocation.offset);
+
+            // empty blocks go back to the device, except the last one able to take this kind of allocation,
+            // which is kept so a type that keeps emptying and refilling does not reallocate every time
+            const bool mixTilings = _bufferImageGranularity <= 1;
+            const bool spare = block->allocatedOrders.empty() && std::ranges::any_of(_blocks, [block, mixTilings](const std::unique_ptr<MemoryBlock>& other) {
+                return other.get() != block
+                    && !other->dedicated
+                    && other->memoryTypeIndex == block->memoryTypeIndex
+                    && (mixTilings || other->tiling == block->tiling);
+            });
+            if (spare)
+                destroyBlock(block);
+        }
+
+        allocation = {};
+    }
+
+    void MemoryAllocator::invalidate(const MemoryAllocation& allocation) const noexcept {
+        if (!allocation.mapped || !_callbacks.invalidate)
+            return;
+
+        const MemoryBlock* block = allocation.block;
+        if (_memoryProperties.memoryTypes[block->memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent)
+            return;
+
+        // buddy nodes start and end on multiples of the minimum allocation, which no nonCoherentAtomSize exceeds;
+        // a dedicated block is its whole memory object
+        static_assert(constants::config::VULKAN_MEMORY_MIN_ALLOCATION % 256 == 0);
+        const vk::DeviceSize minAllocation = constants::config::VULKAN_MEMORY_MIN_ALLOCATION;
+        const vk::DeviceSize size = block->dedicated
+            ? VK_WHOLE_SIZE
+            : (allocation.size + minAllocation - 1) / minAllocation * minAllocation;
+        _callbacks.invalidate(allocation.memory, allocation.offset, size);
+    }
+
+    MemoryAllocatorStats MemoryAllocator::getStats() const noexcept {
+        std::scoped_lock lock{ _mutex };
+        return _stats;
+    }
+
+    uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags vProperties) const noexcept {
+        for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; ++i) {
+            if ((typeFilter & (1u << i)) && (_memoryProperties.memoryTypes[i].propertyFlags & vProperties) == vProperties)
+                return i;
+        }
+
+        Logger::instance().err(std::format("{}\n", constants::messages::VULKAN_NO_SUITABLE_MEMORY_TYPE));
+        return std::numeric_limits<uint32_t>::max();
+    }
+
+    MemoryBlock* MemoryAllocator::createBlock(uint32_t memoryTypeIndex, vk::DeviceSize size, AllocationTiling tiling, bool dedicated) noexcept {
+        vk::DeviceMemory memory = _callbacks.allocate(memoryTypeIndex, size);
+        if (!memory)
+            return nullptr;
+
+        auto block = std::make_unique<MemoryBlock>();
+        block->memory = memory;
+        block->size = size;
+        block->memoryTypeIndex = memoryTypeIndex;
+        block->tiling = tiling;
+        block->dedicated = dedicated;
+
+        // host visible blocks stay mapped for their whole lifetime
+        const bool hostVisible = static_cast<bool>(_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible);
+        block->mapped = hostVisible ? _callbacks.map(memory, size) : nullptr;
+
+        if (!dedicated) {
+            block->freeLists.resize(_maxOrder + 1);
+            block->freeLists[_maxOrder].insert(0);
+        }
+
+        _stats.blockBytes += size;
+        ++_stats.blockCount;
+
+        _blocks.push_back(std::move(block));
+        return _blocks.back().get();
+    }
+
+    void MemoryAllocator::destroyBlock(MemoryBlock* block) noexcept {
+        _stats.blockBytes -= block->size;
+        --_stats.blockCount;
+        _callbacks.free(block->memory);
+        std::erase_if(_blocks, [block](const std::unique_ptr<MemoryBlock>& candidate) { return candidate.get() == block; });
+    }
+
+    bool MemoryAllocator::allocateFromBlock(MemoryBlock& block, uint32_t order, vk::DeviceSize& offset) noexcept {
+        uint32_t found = order;
+        while (found <= _maxOrder && block.freeLists[found].empty())
+            ++found;
+
+        if (found > _maxOrder)
+            return false;
+
+        offset = *block.freeLists[found].begin();
+        block.freeLists[found].erase(block.freeLists[found].begin());
+
+        // split down, returning the upper halves to the free lists
+        while (found > order) {
+            --found;
+            block.freeLists[found].insert(offset + orderSize(found));
+        }
+
+        block.allocatedOrders[offset] = order;
+        return true;
+    }
+
+    void MemoryAllocator::freeInBlock(MemoryBlock& block, vk::DeviceSize offset) noexcept {
+        auto allocated = block.allocatedOrders.find(offset);
+        uint32_t order = allocated->second;
+        block.allocatedOrders.erase(allocated);
+
+        // merge with free buddies as far up as they go
+        while (order < _maxOrder) {
+            const vk::DeviceSize buddy = offset ^ orderSize(order);
+            auto& freeList = block.freeLists[order];
+            auto buddyIt = freeList.find(buddy);
+            if (buddyIt == freeList.end())
+                break;
+
+            freeList.erase(buddyIt);
+            offset = std::min(offset, buddy);
+            ++order;
+        }
+
+        block.freeLists[order].insert(offset);
+    }
+
+    uint32_t MemoryAllocator::orderFor(vk::DeviceSize size) const noexcept {
+        const vk::DeviceSize nodeSize = std::bit_ceil(std::max(size, constants::config::VULKAN_MEMORY_MIN_ALLOCATION));
+        return static_cast<uint32_t>(std::countr_zero(nodeSize / constants::config::VULKAN_MEMORY_MIN_ALLOCATION));
+    }
+
+    vk::DeviceSize MemoryAllocator::orderSize(uint32_t order) const noexcept {
+        return constants::config::VULKAN_MEMORY_MIN_ALLOCATION << order;
+    }
+}
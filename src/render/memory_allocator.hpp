@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "../utility/types.hpp"
+
+namespace tv {
+    // buffers and linear images vs optimal images, kept apart per bufferImageGranularity
+    enum class AllocationTiling {
+        linear,
+        optimal
+    };
+
+    // device memory entry points, swappable for a fake memory-type table on CPU
+    struct MemoryBlockCallbacks {
+        std::function<vk::DeviceMemory(uint32_t memoryTypeIndex, vk::DeviceSize size)> allocate;
+        std::function<void(vk::DeviceMemory memory)> free;
+        std::function<void*(vk::DeviceMemory memory, vk::DeviceSize size)> map;
+        std::function<void(vk::DeviceMemory memory, vk::DeviceSize offset, vk::DeviceSize size)> invalidate;
+    };
+
+    struct MemoryBlock;
+
+    struct MemoryAllocation {
+        vk::DeviceMemory memory;
+        vk::DeviceSize offset;
+        vk::DeviceSize size;
+        void* mapped;
+        MemoryBlock* block;
+    };
+
+    struct MemoryAllocatorStats {
+        vk::DeviceSize blockBytes;
+        vk::DeviceSize usedBytes;
+        vk::DeviceSize wastedBytes;
+        std::size_t blockCount;
+        std::size_t allocationCount;
+    };
+
+    // grabs large blocks per memory type and hands out buddy-allocated ranges from them
+    class MemoryAllocator {
+    public:
+        TV_NCM(MemoryAllocator)
+
+        MemoryAllocator(const vk::PhysicalDeviceMemoryProperties& memoryProperties, vk::DeviceSize bufferImageGranularity, MemoryBlockCallbacks callbacks, vk::DeviceSize blockSize) noexcept;
+
+        ~MemoryAllocator();
+
+        [[nodiscard]] static MemoryBlockCallbacks deviceCallbacks(vk::Device vDevice) noexcept;
+
+        [[nodiscard]] MemoryAllocation allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags vProperties, AllocationTiling tiling) noexcept;
+        void free(MemoryAllocation& allocation) noexcept;
+        // makes device writes visible to host reads of a mapped allocation, nothing to do for coherent memory
+        void invalidate(const MemoryAllocation& allocation) const noexcept;
+        [[nodiscard]] MemoryAllocatorStats getStats() const noexcept;
+        [[nodiscard]] uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags vProperties) const noexcept;
+
+    private:
+        [[nodiscard]] MemoryBlock* createBlock(uint32_t memoryTypeIndex, vk::DeviceSize size, AllocationTiling tiling, bool dedicated) noexcept;
+        void destroyBlock(MemoryBlock* block) noexcept;
+        [[nodiscard]] bool allocateFromBlock(MemoryBlock& block, uint32_t order, vk::DeviceSize& offset) noexcept;
+        void freeInBlock(MemoryBlock& block, vk::DeviceSize offset) noexcept;
+        [[nodiscard]] uint32_t orderFor(vk::DeviceSize size) const noexcept;
+        [[nodiscard]] vk::DeviceSize orderSize(uint32_t order) const noexcept;
+
+        vk::PhysicalDeviceMemoryProperties _memoryProperties;
+        vk::DeviceSize _bufferImageGranularity;
+        MemoryBlockCallbacks _callbacks;
+        vk::DeviceSize _blockSize;
+        uint32_t _maxOrder;
+        std::vector<std::unique_ptr<MemoryBlock>> _blocks;
+        MemoryAllocatorStats _stats;
+        mutable std::mutex _mutex;
+    };
+
+    struct MemoryBlock {
+        vk::DeviceMemory memory;
+        vk::DeviceSize size;
+        void* mapped;
+        uint32_t memoryTypeIndex;
+        AllocationTiling tiling;
+        bool dedicated;
+        // free node offsets per buddy order, order 0 being the minimum allocation
+        std::vector<std::set<vk::DeviceSize>> freeLists;
+        std::unordered_map<vk::DeviceSize, uint32_t> allocatedOrders;
+    };
+}
@@ -0,0 +1,134 @@
+#include "pipeline_manager.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace tv {
+    PipelineManager::PipelineManager(vk::Device vDevice) noexcept
+        : _vDevice{ vDevice },
+          _compilingCount{ 0 }
+    {}
+
+    PipelineManager::~PipelineManager() {
+        for (Entry& entry : _entries) {
+            JobSystem::instance().wait(entry.counter);
+            // failed or never swapped in compilations leave null handles behind
+            if (entry.pipeline)
+                _vDevice.destroyPipeline(entry.pipeline);
+            if (entry.compiled)
+                _vDevice.destroyPipeline(entry.compiled);
+        }
+
+        destroyRetired(std::numeric_limits<uint64_t>::max());
+    }
+
+    PipelineHandle PipelineManager::request(PipelineCompiler compiler, PipelineHandle fallback) noexcept {
+        assert(fallback == noPipeline || fallback < _entries.size());
+
+        Entry& entry = _entries.emplace_back();
+        entry.compiler = std::move(compiler);
+        entry.fallback = fallback;
+        entry.pipeline = nullptr;
+        entry.compiled = nullptr;
+        entry.compiling = false;
+        entry.outdated = false;
+        compile(entry);
+
+        return static_cast<PipelineHandle>(_entries.size() - 1);
+    }
+
+    void PipelineManager::rebuild(PipelineHandle handle) noexcept {
+        Entry& entry = _entries[handle];
+        if (entry.compiling)
+            entry.outdated = true;
+        else
+            compile(entry);
+    }
+
+    void PipelineManager::update(uint64_t submittedFrame) noexcept {
+        if (_compilingCount == 0)
+            return;
+
+        for (Entry& entry : _entries) {
+            if (!entry.compiling || !entry.counter.done())
+                continue;
+
+            entry.compiling = false;
+            --_compilingCount;
+
+            if (entry.outdated) {
+                if (entry.compiled)
+                    _vDevice.destroyPipeline(std::exchange(entry.compiled, nullptr));
+                entry.outdated = false;
+                compile(entry);
+                continue;
+            }
+
+            // a failed compilation, e.g. of a shader that does not link, keeps the running pipeline
+            if (!entry.compiled)
+                continue;
+
+            if (entry.pipeline)
+                _retired.push_back(RetiredPipeline{ entry.pipeline, submittedFrame });
+            entry.pipeline = std::exchange(entry.compiled, nullptr);
+        }
+    }
+
+    void PipelineManager::wait(PipelineHandle handle) noexcept {
+        JobSystem::instance().wait(_entries[handle].counter);
+    }
+
+    void PipelineManager::destroyRetired(uint64_t completedFrame) noexcept {
+        std::erase_if(_retired, [this, completedFrame](const RetiredPipeline& retired) {
+            if (retired.retireValue > completedFrame)
+                return false;
+
+            _vDevice.destroyPipeline(retired.pipeline);
+            return true;
+        });
+    }
+
+    bool PipelineManager::hasRetired() const noexcept {
+        return !_retired.empty();
+    }
+
+    bool PipelineManager::isCompiling() const noexcept {
+        return _compilingCount > 0;
+    }
+
+    vk::Pipeline PipelineManager::get(PipelineHandle handle) const noexcept {
+        // fallbacks may have fallbacks of their own
+        while (handle != noPipeline) {
+            const Entry& entry = _entries[handle];
+            if (entry.pipeline)
+                return entry.pipeline;
+
+            handle = entry.fallback;
+        }
+
+        return nullptr;
+    }
+
+    void PipelineManager::compile(Entry& entry) noexcept {
+        entry.compiling = true;
+        ++_compilingCount;
+
+        // without pool threads the job would only run inside a wait, which the frame loop never reaches
+        if (JobSystem::instance().getWorkerCount() == 1) {
+            entry.compiled = entry.compiler();
+            return;
+        }
+
+        JobSystem::instance().run(Job{
+            [](void* data, std::size_t, std::size_t) {
+                Entry* compiled = static_cast<Entry*>(data);
+                compiled->compiled = compiled->compiler();
+            },
+            &entry,
+            0,
+            1,
+            nullptr
+        }, entry.counter);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "../jobs/job_system.hpp"
+#include "../utility/types.hpp"
+
+namespace tv {
+    using PipelineHandle = uint32_t;
+    // returns null when compilation fails; runs on a job system worker, or inline with a single worker
+    using PipelineCompiler = std::function<vk::Pipeline()>;
+
+    inline constexpr PipelineHandle noPipeline = std::numeric_limits<PipelineHandle>::max();
+
+    // compiles pipelines on job system workers: a handle is returned at once and resolves to its fallback,
+    // or to null, until update swaps the finished pipeline in. Compilers share the renderer's pipeline cache,
+    // which Vulkan synchronizes internally. Everything but the compilers runs on the render thread,
+    // and so do the compilers when the job system has no pool threads
+    class PipelineManager {
+    public:
+        TV_NCM(PipelineManager)
+
+        explicit PipelineManager(vk::Device vDevice) noexcept;
+
+        // waits for compilations still running
+        ~PipelineManager();
+
+        [[nodiscard]] PipelineHandle request(PipelineCompiler compiler, PipelineHandle fallback = noPipeline) noexcept;
+        // compiles the handle again, the current pipeline stays in use until the new one is swapped in
+        void rebuild(PipelineHandle handle) noexcept;
+        // swaps in finished compilations; frames up to submittedFrame may still bind what they replace
+        void update(uint64_t submittedFrame) noexcept;
+        // blocks until the handle's compilation is done, the next update swaps it in
+        void wait(PipelineHandle handle) noexcept;
+        void destroyRetired(uint64_t completedFrame) noexcept;
+        [[nodiscard]] bool hasRetired() const noexcept;
+        [[nodiscard]] bool isCompiling() const noexcept;
+        [[nodiscard]] vk::Pipeline get(PipelineHandle handle) const noexcept;
+
+    private:
+        struct Entry {
+            PipelineCompiler compiler;
+            PipelineHandle fallback;
+            // bound by recorded frames
+            vk::Pipeline pipeline;
+            // written by the compile job, read once its counter is done
+            vk::Pipeline compiled;
+            bool compiling;
+            // rebuilt while compiling, the running compilation may have read stale inputs
+            bool outdated;
+            JobCounter counter;
+        };
+
+        // replaced by a newer compilation but possibly still bound by frames in flight
+        struct RetiredPipeline {
+            vk::Pipeline pipeline;
+            // frame timeline value after which no frame binds it anymore
+            uint64_t retireValue;
+        };
+
+        void compile(Entry& entry) noexcept;
+
+        vk::Device _vDevice;
+        // a deque, jobs point into entries while new ones are requested
+        std::deque<Entry> _entries;
+        std::vector<RetiredPipeline> _retired;
+        std::size_t _compilingCount;
+    };
+}
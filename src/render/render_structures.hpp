@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "memory_allocator.hpp"
+#include "pipeline_manager.hpp"
+
+namespace tv {
+    class Scene;
+}
+
+// the structures holding allocations and pipeline handles, utility/structures.hpp stays free of render headers
+namespace tv::structures {
+    struct VBuffer {
+        vk::Buffer buffer;
+        tv::MemoryAllocation allocation;
+        void* mapped;
+        vk::DeviceSize size;
+    };
+
+    // owned by one swapchain (or offscreen) image, indexed by the acquired image index
+    struct VSwapChainImage {
+        vk::Image image;
+        tv::MemoryAllocation imageAllocation;
+        vk::ImageView imageView;
+        vk::Framebuffer framebuffer;
+        // present waits on it, so it must outlive the frame until the image is acquired again
+        vk::Semaphore renderFinished;
+        // headless only, host copy of the rendered target
+        VBuffer readbackBuffer;
+    };
+
+    // owned by one frame in flight, indexed by the frame number whatever image it renders to
+    struct VFrame {
+        vk::CommandBuffer commandBuffer;
+        std::vector<vk::CommandPool> workerCommandPools;
+        std::vector<vk::CommandBuffer> workerCommandBuffers;
+        vk::CommandBuffer transferCommandBuffer;
+        vk::Semaphore imageAvailable;
+        vk::Semaphore uploadFinished;
+        // frame timeline value signalled by this slot's last submission, 0 before the first one
+        uint64_t timelineValue;
+        VBuffer instanceBuffer;
+        // indices of the instances to draw, filled by the cull shader or, without GPU culling, by the CPU
+        VBuffer visibleBuffer;
+        uint32_t visibleCount;
+        VBuffer drawBuffer;
+        std::size_t instanceCapacity;
+        vk::DeviceSize stagingOffset;
+        // source scene and version of the snapshot the instance buffer was last uploaded from,
+        // chunks changed since then are uploaded again whichever snapshot of that scene comes next
+        const Scene* uploadedScene;
+        uint64_t uploadedSceneVersion;
+        vk::DescriptorSet descriptorSet;
+        vk::DescriptorSet cullDescriptorSet;
+        vk::QueryPool timestampQueryPool;
+        bool timestampsWritten;
+    };
+
+    struct VSwapChainBundle {
+        vk::SwapchainKHR swapChain;
+        std::vector<VSwapChainImage> images;
+        vk::Format format;
+        vk::Extent2D extent;
+    };
+
+    // replaced by a recreation but possibly still rendered to or presented by frames in flight
+    struct VRetiredSwapchain {
+        vk::SwapchainKHR swapChain;
+        std::vector<VSwapChainImage> images;
+        // frame timeline value after which nothing can reference the images anymore
+        uint64_t retireValue;
+    };
+
+    struct VGraphicsPipelineBundle {
+        // both layouts are owned by the layout cache and may be shared with other pipelines
+        vk::DescriptorSetLayout descriptorSetLayout;
+        vk::PipelineLayout layout;
+        vk::RenderPass renderpass;
+        // compiled in the background; pipeline is what this frame binds, null until the handle is ready
+        PipelineHandle handle;
+        vk::Pipeline pipeline;
+    };
+
+    struct VComputePipelineBundle {
+        // owned by the layout cache
+        vk::DescriptorSetLayout descriptorSetLayout;
+        vk::PipelineLayout layout;
+        PipelineHandle handle;
+        vk::Pipeline pipeline;
+    };
+
+    struct VCommandBufferInput {
+        vk::Device device;
+        vk::CommandPool commandPool;
+        std::vector<VFrame>& frames;
+    };
+}
@@ -2,22 +2,39 @@
 
 #include <format>
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <set>
 #include <string>
 #include <limits>
 #include <mutex>
+#include <chrono>
 #include <cassert>
+#include <cstddef>
 #include <cstring>
+#include <filesystem>
+#include <span>
 
 #include "../logger.hpp"
+#include "../jobs/job_system.hpp"
 #include "../services/file_service.hpp"
 #include "../utility/messages.hpp"
 #include "../utility/config.hpp"
 #include "../utility/paths.hpp"
 #include "../shaders/models/triangle.hpp"
+#include "../shaders/models/camera.hpp"
+#include "../shaders/models/cull.hpp"
+#include "../scene/frustum.hpp"
+#include "../scene/transform_kernel.hpp"
+#include "shader_reflection.hpp"
 
 namespace tv {
     namespace {
+        // the build reflects the compiled shaders, their interface has to match what is filled in here
+        static_assert(shader::reflection::triangleVert::PUSH_CONSTANT_SIZE == sizeof(shader::model::Camera));
+        static_assert(shader::reflection::cullComp::PUSH_CONSTANT_SIZE == sizeof(shader::model::Cull));
+        static_assert(shader::reflection::cullComp::LOCAL_SIZE[0] == constants::config::VULKAN_CULL_WORKGROUP_SIZE);
+
 #if(TV_DEBUG_MODE)
         VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
             VkDebugUtilsMessageSeverityFlagBitsEXT /* messageSeverity */,
@@ -28,28 +45,78 @@ namespace tv {
             return VK_FALSE;
         }
 #endif
+        // shared by both setup entry points so the singleton is initialized exactly once
+        std::once_flag setupFlag;
+
+        constexpr vk::Format offscreenFormat = vk::Format::eB8G8R8A8Unorm;
+        constexpr std::size_t offscreenPixelSize = 4;
+        constexpr uint32_t timestampQueryCount = 2;
+
+        double toMilliseconds(std::chrono::steady_clock::duration duration) noexcept {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
     }
 
     Renderer::Renderer() noexcept
         : _window{ nullptr },
           _vInstance{ nullptr },
+          _vInstanceApiVersion{ 0 },
           _vPhysicalDevice{ nullptr },
+          _vApiVersion{ 0 },
           _vDevice{ nullptr },
           _vGraphicsQueue{ nullptr },
           _vPresentQueue{ nullptr },
-          _vDebugMessenger{ nullptr }
-    {}
+          _vTransferQueue{ nullptr },
+          _vSwapchainOutdated{ false },
+          _vDebugMessenger{ nullptr },
+          _vPipelineCache{ nullptr },
+          _vFrameTimeline{ nullptr },
+          _vSubmittedFrame{ 0 },
+          _vGpuCulling{ false },
+          _vDynamicRendering{ false },
+          _vTimestampPeriod{ 0.0f },
+          _vTimestampMask{ 0 },
+          _frameTimings{ constants::config::FRAME_TIMINGS_CAPACITY },
+          _visibleInstanceCount{ 0 }
+    {
+        // constructed first so it is destroyed last, pipeline compilations are still waited for on destruction
+        JobSystem::instance();
+    }
 
     Renderer::~Renderer() {
         _vDevice.waitIdle();
+        // compilations still running read the layouts, modules and cache destroyed below
+        _pipelineManager.reset();
+        _shaderLibrary.reset();
 
         _vDevice.destroyCommandPool(_vCommandPool);
+        _vDevice.destroyCommandPool(_vTransferCommandPool);
 
-        _vDevice.destroyPipeline(_vGraphicsPipelineBundle.pipeline);
-        _vDevice.destroyPipelineLayout(_vGraphicsPipelineBundle.layout);
         _vDevice.destroyRenderPass(_vGraphicsPipelineBundle.renderpass);
 
+        savePipelineCache(_vDevice, _vPhysicalDevice, _vPipelineCache);
+        _vDevice.destroyPipelineCache(_vPipelineCache);
+
+#if(TV_DEBUG_MODE)
+        const MemoryAllocatorStats memoryStats = _memoryAllocator->getStats();
+        Logger::instance().log(std::format(
+            "{}: {} blocks, {} bytes, {} used, {} wasted, {} allocations\n",
+            constants::messages::VULKAN_MEMORY_STATS,
+            memoryStats.blockCount,
+            memoryStats.blockBytes,
+            memoryStats.usedBytes,
+            memoryStats.wastedBytes,
+            memoryStats.allocationCount
+        ));
+#endif
         resetSwapchain();
+        destroyFrames();
+        _vDevice.destroySemaphore(_vFrameTimeline);
+        destroyBuffer(_vDevice, _vStagingBuffer);
+        _memoryAllocator.reset();
+        _vDevice.destroyDescriptorPool(_vDescriptorPool);
+        // owns the pipeline and descriptor set layouts of both bundles
+        _layoutCache.reset();
         _vDevice.destroy();
 
         _vInstance.destroySurfaceKHR(_vSurface);
@@ -60,61 +127,140 @@ namespace tv {
     }
 
     void Renderer::setup(Renderer& renderer, GLFWwindow* window) noexcept {
-        static std::once_flag setupFlag;
+        assert(window);
         std::call_once(setupFlag, [&renderer, window]() {
-            renderer.init(window);
+            renderer.init(window, {});
+        });
+    }
+
+    void Renderer::setupHeadless(Renderer& renderer, vk::Extent2D extent) noexcept {
+        std::call_once(setupFlag, [&renderer, extent]() {
+            renderer.init(nullptr, extent);
         });
     }
 
-    void Renderer::render(Scene* scene) noexcept {
-        auto waitResult = _vDevice.waitForFences(1, &_vSwapChainBundle.frames[_vFrameNumber].inFlight, VK_TRUE, UINT64_MAX);
-        if (waitResult != vk::Result::eSuccess)
+    void Renderer::render(const SceneSnapshot* snapshot) noexcept {
+        if (headless()) {
+            renderOffscreen(snapshot);
+            return;
+        }
+
+        if (_vSwapchainOutdated) {
+            recreateSwapchain();
+            if (_vSwapchainOutdated)
+                return;
+        }
+
+        if (!_vRetiredSwapchains.empty())
+            destroyRetiredSwapchains(getCompletedFrame());
+
+        if (_pipelineManager->hasRetired())
+            _pipelineManager->destroyRetired(getCompletedFrame());
+
+        if (_shaderLibrary->isWatching())
+            reloadShaders();
+        updatePipelines();
+
+        FrameTiming timing{};
+        const auto frameStart = std::chrono::steady_clock::now();
+
+        structures::VFrame& frame = _vFrames[_vFrameNumber];
+        if (!waitForFrameSlot(frame))
             return;
 
-        auto resetResult = _vDevice.resetFences(1, &_vSwapChainBundle.frames[_vFrameNumber].inFlight);
-        if (resetResult != vk::Result::eSuccess)
+        const auto slotWaited = std::chrono::steady_clock::now();
+        timing.frameWait = toMilliseconds(slotWaited - frameStart);
+
+        // staged before the acquire, so failing here leaves no semaphore signalled
+        reserveFrameInstances(frame, snapshot->getInstanceCount());
+        if (!stageFrameInstances(frame, snapshot->getInstanceCount()))
             return;
 
-        vk::ResultValue acquireResult = _vDevice.acquireNextImageKHR(_vSwapChainBundle.swapChain, UINT64_MAX, _vSwapChainBundle.frames[_vFrameNumber].imageAvailable, nullptr);
+        const auto staged = std::chrono::steady_clock::now();
+
+        vk::ResultValue acquireResult = _vDevice.acquireNextImageKHR(_vSwapChainBundle.swapChain, UINT64_MAX, frame.imageAvailable, nullptr);
         if (acquireResult.result == vk::Result::eErrorOutOfDateKHR) {
             recreateSwapchain();
             return;
         }
 
+        const auto acquired = std::chrono::steady_clock::now();
+        timing.acquire = toMilliseconds(acquired - staged);
+
         uint32_t imageIndex = acquireResult.value;
-        vk::CommandBuffer commandBuffer = _vSwapChainBundle.frames[_vFrameNumber].commandBuffer;
+        structures::VSwapChainImage& image = _vSwapChainBundle.images[imageIndex];
+        vk::CommandBuffer commandBuffer = frame.commandBuffer;
+
+        readVisibleInstanceCount(frame);
+
+        // this slot's queries belong to its previous submission, so GPU time lags by the frames in flight
+        timing.gpu = readGpuTime(frame);
 
-        commandBuffer.reset();
+        cullFrameInstances(frame, snapshot);
+        const auto culled = std::chrono::steady_clock::now();
+        timing.cull = toMilliseconds(staged - slotWaited) + toMilliseconds(culled - acquired);
 
-        recordDrawCommands(commandBuffer, imageIndex, _vGraphicsPipelineBundle, _vSwapChainBundle, scene);
+        recordFrame(frame, imageIndex, snapshot, JobSystem::instance().getWorkerCount());
+        if (!submitUpload(frame, snapshot)) {
+            // the acquired image is never presented, a new swapchain gives it back
+            abandonFrame(frame, { frame.imageAvailable });
+            _vSwapchainOutdated = true;
+            return;
+        }
+
+        const auto recorded = std::chrono::steady_clock::now();
+        timing.record = toMilliseconds(recorded - culled);
 
         vk::SubmitInfo submitInfo{};
 
-        vk::Semaphore waitSemaphores[] = { _vSwapChainBundle.frames[_vFrameNumber].imageAvailable };
-        vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
-        submitInfo.waitSemaphoreCount = 1;
+        vk::Semaphore waitSemaphores[] = { frame.imageAvailable, frame.uploadFinished };
+        vk::PipelineStageFlags waitStages[] = {
+            vk::PipelineStageFlagBits::eColorAttachmentOutput,
+            vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eVertexShader
+        };
+        submitInfo.waitSemaphoreCount = 2;
         submitInfo.pWaitSemaphores = waitSemaphores;
         submitInfo.pWaitDstStageMask = waitStages;
 
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &commandBuffer;
 
-        vk::Semaphore signalSemaphores[] = { _vSwapChainBundle.frames[_vFrameNumber].renderFinished };
-        submitInfo.signalSemaphoreCount = 1;
+        vk::Semaphore signalSemaphores[] = { image.renderFinished, _vFrameTimeline };
+        submitInfo.signalSemaphoreCount = 2;
         submitInfo.pSignalSemaphores = signalSemaphores;
 
+        // binary semaphores ignore their entry, only the timeline takes a value
+        const uint64_t frameValue = _vSubmittedFrame + 1;
+        const uint64_t waitValues[] = { 0, 0 };
+        const uint64_t signalValues[] = { 0, frameValue };
+        vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.waitSemaphoreValueCount = 2;
+        timelineInfo.pWaitSemaphoreValues = waitValues;
+        timelineInfo.signalSemaphoreValueCount = 2;
+        timelineInfo.pSignalSemaphoreValues = signalValues;
+        submitInfo.pNext = &timelineInfo;
+
         try {
-            _vGraphicsQueue.submit(submitInfo, _vSwapChainBundle.frames[_vFrameNumber].inFlight);
+            _vGraphicsQueue.submit(submitInfo, nullptr);
         } catch (const vk::SystemError& err) {
 #if(TV_DEBUG_MODE)
             Logger::instance().log(std::format("{}\n", err.what()));
 #endif
+            abandonFrame(frame, { frame.imageAvailable, frame.uploadFinished });
+            _vSwapchainOutdated = true;
             return;
         }
 
+        _vSubmittedFrame = frameValue;
+        frame.timelineValue = frameValue;
+        frame.timestampsWritten = frame.timestampQueryPool != nullptr;
+
+        const auto submitted = std::chrono::steady_clock::now();
+        timing.submit = toMilliseconds(submitted - recorded);
+
         vk::PresentInfoKHR presentInfo{};
         presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = signalSemaphores;
+        presentInfo.pWaitSemaphores = &image.renderFinished;
 
         vk::SwapchainKHR swapChains[] = { _vSwapChainBundle.swapChain };
         presentInfo.swapchainCount = 1;
@@ -132,38 +278,335 @@ namespace tv {
             presentResult = vk::Result::eErrorOutOfDateKHR;
         }
 
-        if (presentResult == vk::Result::eErrorOutOfDateKHR || presentResult == vk::Result::eSuboptimalKHR) {
+        timing.present = toMilliseconds(std::chrono::steady_clock::now() - submitted);
+        pushFrameTiming(timing, frameStart);
+
+        // the frame was submitted either way, so its slot is done with
+        _vFrameNumber = (_vFrameNumber + 1) % _vMaxFramesInFlight;
+
+        if (presentResult == vk::Result::eErrorOutOfDateKHR || presentResult == vk::Result::eSuboptimalKHR)
             recreateSwapchain();
+    }
+
+    void Renderer::renderOffscreen(const SceneSnapshot* snapshot) noexcept {
+        updatePipelines();
+
+        FrameTiming timing{};
+        const auto frameStart = std::chrono::steady_clock::now();
+
+        structures::VFrame& frame = _vFrames[_vFrameNumber];
+        if (!waitForFrameSlot(frame))
+            return;
+
+        const auto slotWaited = std::chrono::steady_clock::now();
+        timing.frameWait = toMilliseconds(slotWaited - frameStart);
+
+        readVisibleInstanceCount(frame);
+
+        timing.gpu = readGpuTime(frame);
+
+        // there is one target per frame in flight, so the frame index doubles as the image index
+        reserveFrameInstances(frame, snapshot->getInstanceCount());
+        if (!stageFrameInstances(frame, snapshot->getInstanceCount()))
+            return;
+
+        cullFrameInstances(frame, snapshot);
+        const auto culled = std::chrono::steady_clock::now();
+        timing.cull = toMilliseconds(culled - slotWaited);
+
+        recordFrame(frame, static_cast<uint32_t>(_vFrameNumber), snapshot, JobSystem::instance().getWorkerCount());
+        if (!submitUpload(frame, snapshot))
+            return;
+
+        const auto recorded = std::chrono::steady_clock::now();
+        timing.record = toMilliseconds(recorded - culled);
+
+        vk::SubmitInfo submitInfo{};
+        const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eVertexShader;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &frame.uploadFinished;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &frame.commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &_vFrameTimeline;
+
+        const uint64_t frameValue = _vSubmittedFrame + 1;
+        const uint64_t waitValue = 0;
+        vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &waitValue;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &frameValue;
+        submitInfo.pNext = &timelineInfo;
+
+        try {
+            _vGraphicsQueue.submit(submitInfo, nullptr);
+        } catch (const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().log(std::format("{}\n", err.what()));
+#endif
+            abandonFrame(frame, { frame.uploadFinished });
             return;
         }
 
+        _vSubmittedFrame = frameValue;
+        frame.timelineValue = frameValue;
+        frame.timestampsWritten = frame.timestampQueryPool != nullptr;
+
+        timing.submit = toMilliseconds(std::chrono::steady_clock::now() - recorded);
+        pushFrameTiming(timing, frameStart);
+
+        _vLastFrameNumber = _vFrameNumber;
         _vFrameNumber = (_vFrameNumber + 1) % _vMaxFramesInFlight;
     }
 
-    void Renderer::init(GLFWwindow* window) noexcept {
-        assert(window);
+    structures::VHostFrame Renderer::getLastFrame() noexcept {
+        if (!headless() || !_vLastFrameNumber)
+            return {};
+
+        structures::VFrame& frame = _vFrames[_vLastFrameNumber.value()];
+        if (!waitForFrame(frame.timelineValue))
+            return {};
+
+        readVisibleInstanceCount(frame);
+
+        const structures::VSwapChainImage& image = _vSwapChainBundle.images[_vLastFrameNumber.value()];
+        _memoryAllocator->invalidate(image.readbackBuffer.allocation);
+        return {
+            static_cast<const uint8_t*>(image.readbackBuffer.mapped),
+            _vSwapChainBundle.extent,
+            _vSwapChainBundle.format,
+            _vSwapChainBundle.extent.width * offscreenPixelSize
+        };
+    }
+
+    uint64_t Renderer::getSubmittedFrame() const noexcept {
+        return _vSubmittedFrame;
+    }
+
+    uint64_t Renderer::getCompletedFrame() const noexcept {
+        try {
+            return _vDevice.getSemaphoreCounterValue(_vFrameTimeline);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+        }
+
+        return 0;
+    }
+
+    bool Renderer::waitForFrame(uint64_t frameValue) const noexcept {
+        if (frameValue == 0)
+            return true;
+
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.flags = vk::SemaphoreWaitFlags();
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &_vFrameTimeline;
+        waitInfo.pValues = &frameValue;
+
+        try {
+            return _vDevice.waitSemaphores(waitInfo, UINT64_MAX) == vk::Result::eSuccess;
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+        }
+
+        return false;
+    }
+
+    bool Renderer::waitForFrameSlot(const structures::VFrame& vFrame) const noexcept {
+        // slots are used round robin, so this also caps the CPU at _vMaxFramesInFlight frames ahead
+        return waitForFrame(vFrame.timelineValue);
+    }
+
+    void Renderer::abandonFrame(structures::VFrame& vFrame, const std::vector<vk::Semaphore>& vSignalledSemaphores) noexcept {
+        // an empty submit waits the signalled semaphores back to unsignalled and completes the slot on the
+        // timeline, so the slot's next acquire and upload find it as a submitted frame would leave it
+        const std::vector<vk::PipelineStageFlags> waitStages(vSignalledSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands);
+        const std::vector<uint64_t> waitValues(vSignalledSemaphores.size(), 0);
+        const uint64_t frameValue = _vSubmittedFrame + 1;
+
+        vk::SubmitInfo submitInfo{};
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(vSignalledSemaphores.size());
+        submitInfo.pWaitSemaphores = vSignalledSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &_vFrameTimeline;
+
+        vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &frameValue;
+        submitInfo.pNext = &timelineInfo;
+
+        try {
+            _vGraphicsQueue.submit(submitInfo, nullptr);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+            return;
+        }
+
+        _vSubmittedFrame = frameValue;
+        vFrame.timelineValue = frameValue;
+        vFrame.timestampsWritten = false;
+        _vFrameNumber = (_vFrameNumber + 1) % _vMaxFramesInFlight;
+    }
+
+    uint32_t Renderer::getVisibleInstanceCount() const noexcept {
+        return _visibleInstanceCount;
+    }
+
+    const FrameTimings& Renderer::getFrameTimings() const noexcept {
+        return _frameTimings;
+    }
+
+    void Renderer::pushFrameTiming(FrameTiming& timing, std::chrono::steady_clock::time_point frameStart) noexcept {
+        // the first frame has no predecessor to measure the interval against
+        if (_lastFrameStart != std::chrono::steady_clock::time_point{}) {
+            timing.frame = toMilliseconds(frameStart - _lastFrameStart);
+            _frameTimings.push(timing);
+        }
+
+        _lastFrameStart = frameStart;
+    }
+
+    void Renderer::benchmarkRecording(const SceneSnapshot* snapshot) noexcept {
+        _vDevice.waitIdle();
+        _pipelineManager->wait(_vGraphicsPipelineBundle.handle);
+        if (_vGpuCulling)
+            _pipelineManager->wait(_vCullPipelineBundle.handle);
+        updatePipelines();
+
+        structures::VFrame& frame = _vFrames[_vFrameNumber];
+        reserveFrameInstances(frame, snapshot->getInstanceCount());
+        if (!stageFrameInstances(frame, snapshot->getInstanceCount()))
+            return;
+
+        cullFrameInstances(frame, snapshot);
+
+        std::vector<std::size_t> workerCounts;
+        const std::size_t maxWorkerCount = JobSystem::instance().getWorkerCount();
+        for (std::size_t workerCount = 1; workerCount < maxWorkerCount; workerCount *= 2)
+            workerCounts.push_back(workerCount);
+        workerCounts.push_back(maxWorkerCount);
+
+        // one chunk per job, so the chunk limit is the number of threads recording at once
+        for (const std::size_t workerCount : workerCounts) {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < constants::config::RECORDING_BENCHMARK_ITERATIONS; ++i)
+                recordFrame(frame, 0, snapshot, workerCount);
+
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            Logger::instance().log(std::format(
+                "{}: {} instances, {} threads: {:.3f} ms\n",
+                constants::messages::VULKAN_RECORDING_BENCHMARK,
+                snapshot->getInstanceCount(),
+                workerCount,
+                elapsed.count() / constants::config::RECORDING_BENCHMARK_ITERATIONS
+            ));
+        }
+    }
+
+    void Renderer::init(GLFWwindow* window, vk::Extent2D extent) noexcept {
         _window = window;
 
+        _vInstanceApiVersion = instanceApiVersion();
         _vInstance = createInstance();
         _vDispatchLoaderDynamic.init(_vInstance, vkGetInstanceProcAddr);
         _vDebugMessenger = createDebugMessenger(_vInstance);
 
-        createSurface(_window, _vInstance, _vSurface);
+        if (headless())
+            Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_HEADLESS_MODE));
+        else
+            createSurface(_window, _vInstance, _vSurface);
 
         _vPhysicalDevice = chooseDevice(_vInstance);
+        _vApiVersion = apiVersion(_vPhysicalDevice);
+        _vGpuCulling = gpuCullingSupported(_vPhysicalDevice);
+#if(TV_DEBUG_MODE)
+        if (_vGpuCulling)
+            Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_GPU_CULLING_ENABLED));
+#endif
+        _vDynamicRendering = dynamicRenderingSupported(_vPhysicalDevice);
+#if(TV_DEBUG_MODE)
+        if (_vDynamicRendering)
+            Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_DYNAMIC_RENDERING_ENABLED));
+#endif
         _vDevice = createLogicalDevice(_vPhysicalDevice, _vSurface);
+        _vQueueFamilies = findQueueFamilies(_vPhysicalDevice, _vSurface);
+#if(TV_DEBUG_MODE)
+        Logger::instance().log(std::format("{}: {}\n", constants::messages::VULKAN_TRANSFER_QUEUE_FAMILY, _vQueueFamilies.transferFamily.value()));
+#endif
+        _memoryAllocator = std::make_unique<MemoryAllocator>(
+            _vPhysicalDevice.getMemoryProperties(),
+            _vPhysicalDevice.getProperties().limits.bufferImageGranularity,
+            MemoryAllocator::deviceCallbacks(_vDevice),
+            constants::config::VULKAN_MEMORY_BLOCK_SIZE
+        );
+        _vTimestampPeriod = timestampPeriod(_vPhysicalDevice, _vSurface);
+        _vTimestampMask = timestampMask(_vPhysicalDevice, _vSurface);
+#if(TV_DEBUG_MODE)
+        if (_vTimestampPeriod > 0.0f)
+            Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_GPU_TIMESTAMPS_ENABLED));
+#endif
 
         auto vQueues = getQueues(_vPhysicalDevice, _vDevice, _vSurface);
-        assert(vQueues.size() == 2);
+        assert(vQueues.size() == 3);
         _vGraphicsQueue = vQueues[0];
         _vPresentQueue = vQueues[1];
-
-        _vSwapChainBundle = createSwapchain(_window, _vDevice, _vPhysicalDevice, _vSurface, _vMaxFramesInFlight);
+        _vTransferQueue = vQueues[2];
+
+        // independent of the image count the driver hands out, latency is tuned here alone
+        _vMaxFramesInFlight = headless()
+            ? constants::config::VULKAN_HEADLESS_FRAMES_IN_FLIGHT
+            : constants::config::VULKAN_FRAMES_IN_FLIGHT;
+        _vFrames.resize(_vMaxFramesInFlight);
+
+        _vSwapChainBundle = headless()
+            ? createOffscreenTargets(_vDevice, extent, _vMaxFramesInFlight)
+            : createSwapchain(_window, _vDevice, _vPhysicalDevice, _vSurface, nullptr);
+        _vPipelineCache = createPipelineCache(_vDevice, _vPhysicalDevice);
+        _shaderLibrary = std::make_unique<ShaderLibrary>(_vDevice);
+        // headless runs end before anyone gets to edit a shader
+        if (!headless())
+            _shaderLibrary->watch(constants::path::SHADERS_PATH);
+        _layoutCache = std::make_unique<LayoutCache>(_vDevice);
+        _pipelineManager = std::make_unique<PipelineManager>(_vDevice);
+        // pipelines compile on workers while the rest of the setup runs
         _vGraphicsPipelineBundle = createPipeline(_vDevice, _vSwapChainBundle);
+        if (_vGpuCulling)
+            _vCullPipelineBundle = createCullPipeline(_vDevice);
 
         _vFrameNumber = 0;
+        _vFrameTimeline = createTimelineSemaphore(_vDevice);
+
+#if(TV_DEBUG_MODE)
+        Logger::instance().log(std::format("{}: {}\n", constants::messages::JOB_WORKERS, JobSystem::instance().getWorkerCount()));
+        Logger::instance().log(std::format("{}: {}\n", constants::messages::SCENE_TRANSFORM_KERNEL, transformKernelName()));
+#endif
+
+        finalSetup(_vDevice, _vPhysicalDevice, _vSurface, _vGraphicsPipelineBundle, _vSwapChainBundle, _vFrames, _vCommandPool, _vMainCommandBuffer);
+
+        _vTransferCommandPool = createCommandPool(_vDevice, _vQueueFamilies.transferFamily.value(), vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+        structures::VCommandBufferInput transferCommandBufferInput = { _vDevice, _vTransferCommandPool, _vFrames };
+        createFrameTransferCommandBuffers(transferCommandBufferInput);
+
+        _vDescriptorPool = createDescriptorPool(_vDevice);
+        createFrameDescriptorSets(_vDevice, _vDescriptorPool, _vGraphicsPipelineBundle.descriptorSetLayout, _vCullPipelineBundle.descriptorSetLayout, _vFrames);
 
-        finalSetup(_vDevice, _vPhysicalDevice, _vSurface, _vGraphicsPipelineBundle, _vSwapChainBundle, _vCommandPool, _vMainCommandBuffer);
+        // windowed frames draw nothing until the pipelines are ready, offscreen frames are read back and must be complete
+        if (headless()) {
+            _pipelineManager->wait(_vGraphicsPipelineBundle.handle);
+            if (_vGpuCulling)
+                _pipelineManager->wait(_vCullPipelineBundle.handle);
+        }
     }
 
     Renderer& Renderer::instance() noexcept {
@@ -189,13 +632,76 @@ namespace tv {
         logger.log(requestedExtensionsMessage);
     }
 
+    bool Renderer::headless() const noexcept {
+        return _window == nullptr;
+    }
+
     bool Renderer::deviceIsSuitable(const vk::PhysicalDevice& vDevice) const noexcept {
-        const std::vector<const char*> requestedExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+        std::vector<const char*> requestedExtensions;
+        if (!headless())
+            requestedExtensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
         std::set<std::string> requiredExtensions{ requestedExtensions.cbegin(), requestedExtensions.cend() };
         const auto deviceExtensions = vDevice.enumerateDeviceExtensionProperties();
         for (const vk::ExtensionProperties& deviceExtension : deviceExtensions)
             requiredExtensions.erase(deviceExtension.extensionName);
-        return requiredExtensions.empty();
+        return requiredExtensions.empty() && timelineSemaphoresSupported(vDevice);
+    }
+
+    uint32_t Renderer::instanceApiVersion() const noexcept {
+        uint32_t version{ 0 };
+        vkEnumerateInstanceVersion(&version);
+        return version;
+    }
+
+    uint32_t Renderer::apiVersion(const vk::PhysicalDevice& vPhysicalDevice) const noexcept {
+        return std::min(_vInstanceApiVersion, vPhysicalDevice.getProperties().apiVersion);
+    }
+
+    bool Renderer::timelineSemaphoresSupported(const vk::PhysicalDevice& vPhysicalDevice) const noexcept {
+        if (apiVersion(vPhysicalDevice) < VK_API_VERSION_1_2)
+            return false;
+
+        const auto features = vPhysicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features.get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore == VK_TRUE;
+    }
+
+    bool Renderer::dynamicRenderingSupported(const vk::PhysicalDevice& vPhysicalDevice) const noexcept {
+        if (apiVersion(vPhysicalDevice) < VK_API_VERSION_1_3)
+            return false;
+
+        const auto features = vPhysicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features>();
+        return features.get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering == VK_TRUE;
+    }
+
+    bool Renderer::gpuCullingSupported(const vk::PhysicalDevice& vPhysicalDevice) const noexcept {
+        if (apiVersion(vPhysicalDevice) < VK_API_VERSION_1_2)
+            return false;
+
+        const auto features = vPhysicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        return features.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount == VK_TRUE;
+    }
+
+    float Renderer::timestampPeriod(const vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept {
+        const structures::VQueueFamilyIndices indices = findQueueFamilies(vPhysicalDevice, vSurface);
+        if (!indices.graphicsFamily)
+            return 0.0f;
+
+        const auto queueFamilies = vPhysicalDevice.getQueueFamilyProperties();
+        if (queueFamilies[indices.graphicsFamily.value()].timestampValidBits == 0)
+            return 0.0f;
+
+        return vPhysicalDevice.getProperties().limits.timestampPeriod;
+    }
+
+    uint64_t Renderer::timestampMask(const vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept {
+        const structures::VQueueFamilyIndices indices = findQueueFamilies(vPhysicalDevice, vSurface);
+        if (!indices.graphicsFamily)
+            return 0;
+
+        // bits above timestampValidBits are undefined in the written values
+        const uint32_t validBits = vPhysicalDevice.getQueueFamilyProperties()[indices.graphicsFamily.value()].timestampValidBits;
+        return validBits >= 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << validBits) - 1;
     }
 
     structures::VQueueFamilyIndices Renderer::findQueueFamilies(const vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept {
@@ -208,15 +714,34 @@ namespace tv {
             if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)
                 indices.graphicsFamily = i;
 
-            if (vPhysicalDevice.getSurfaceSupportKHR(i, vSurface))
+            if (vSurface && vPhysicalDevice.getSurfaceSupportKHR(i, vSurface))
                 indices.presentFamily = i;
 
+            // headless: nothing is presented, the graphics queue stands in
+            if (!vSurface)
+                indices.presentFamily = indices.graphicsFamily;
+
             if (indices.isComplete())
                 break;
 
             ++i;
         }
 
+        // a family with transfer but neither graphics nor compute is the copy engine on discrete GPUs
+        for (uint32_t i = 0; const vk::QueueFamilyProperties& queueFamily : queueFamilies) {
+            if ((queueFamily.queueFlags & vk::QueueFlagBits::eTransfer)
+                && !(queueFamily.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+                indices.transferFamily = i;
+                break;
+            }
+
+            ++i;
+        }
+
+        // graphics queues always support transfers
+        if (!indices.transferFamily)
+            indices.transferFamily = indices.graphicsFamily;
+
         return indices;
     }
 
@@ -319,49 +844,17 @@ namespace tv {
         return extent;
     }
 
-    vk::ShaderModule Renderer::createShaderModule(const std::string& filePath, vk::Device& vDevice) const noexcept {
-        std::vector<char> sourceCode = service::FileService::read(filePath);
-        assert(!sourceCode.empty());
-        vk::ShaderModuleCreateInfo moduleInfo{};
-        moduleInfo.flags = vk::ShaderModuleCreateFlags();
-        moduleInfo.codeSize = sourceCode.size();
-        moduleInfo.pCode = reinterpret_cast<const uint32_t*>(sourceCode.data());
-
-        try {
-            return vDevice.createShaderModule(moduleInfo);
-        } catch ([[maybe_unused]] const vk::SystemError& err) {
-#if(TV_DEBUG_MODE)
-            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_SHADER_MODULE_CREATION_FAILED, err.what()));
-#endif
-        }
-
-        return {};
-    }
-
-    vk::PipelineLayout Renderer::createPipelineLayout(vk::Device& vDevice) const noexcept {
-        vk::PipelineLayoutCreateInfo layoutInfo;
-        layoutInfo.flags = vk::PipelineLayoutCreateFlags();
-        layoutInfo.setLayoutCount = 0;
-
-        vk::PushConstantRange pushConstantRange;
-        pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(shader::model::Triangle);
-        pushConstantRange.stageFlags = vk::ShaderStageFlagBits::eVertex;
-        layoutInfo.pPushConstantRanges = &pushConstantRange;
-        layoutInfo.pushConstantRangeCount = 1;
-
-        try {
-            return vDevice.createPipelineLayout(layoutInfo);
-        } catch ([[maybe_unused]] const vk::SystemError& err) {
-#if(TV_DEBUG_MODE)
-            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_PIPELINE_LAYOUT_CREATION_FAILED, err.what()));
-#endif
-        }
+    ReflectedLayout Renderer::createReflectedLayout(std::initializer_list<std::string> filePaths) const noexcept {
+        // a stage that does not load adds nothing, its pipeline fails to compile anyway
+        std::vector<shader::Reflection> stages;
+        for (const std::string& filePath : filePaths)
+            if (std::optional<shader::Reflection> reflection = _shaderLibrary->getReflection(filePath))
+                stages.push_back(std::move(reflection.value()));
 
-        return {};
+        return _layoutCache->getLayout(stages);
     }
 
-    vk::RenderPass Renderer::createRenderpass(vk::Device& vDevice, vk::Format vSwapchainImageFormat) const noexcept {
+    vk::RenderPass Renderer::createRenderpass(vk::Device& vDevice, vk::Format vSwapchainImageFormat, vk::ImageLayout vFinalLayout) const noexcept {
         vk::AttachmentDescription colorAttachment{};
         colorAttachment.flags = vk::AttachmentDescriptionFlags();
         colorAttachment.format = vSwapchainImageFormat;
@@ -371,7 +864,7 @@ namespace tv {
         colorAttachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
         colorAttachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
         colorAttachment.initialLayout = vk::ImageLayout::eUndefined;
-        colorAttachment.finalLayout = vk::ImageLayout::ePresentSrcKHR;
+        colorAttachment.finalLayout = vFinalLayout;
 
         vk::AttachmentReference colorAttachmentRef{};
         colorAttachmentRef.attachment = 0;
@@ -383,12 +876,35 @@ namespace tv {
         subpass.colorAttachmentCount = 1;
         subpass.pColorAttachments = &colorAttachmentRef;
 
+        // the clear and the layout transition wait for the acquire semaphore, which is waited on at this stage
+        std::vector<vk::SubpassDependency> dependencies(1);
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = 0;
+        dependencies[0].srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+        dependencies[0].srcAccessMask = vk::AccessFlags();
+        dependencies[0].dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+        dependencies[0].dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+
+        if (vFinalLayout == vk::ImageLayout::eTransferSrcOptimal) {
+            // the readback copy follows the render pass
+            vk::SubpassDependency readbackDependency{};
+            readbackDependency.srcSubpass = 0;
+            readbackDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+            readbackDependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+            readbackDependency.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+            readbackDependency.dstStageMask = vk::PipelineStageFlagBits::eTransfer;
+            readbackDependency.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+            dependencies.push_back(readbackDependency);
+        }
+
         vk::RenderPassCreateInfo renderpassInfo{};
         renderpassInfo.flags = vk::RenderPassCreateFlags();
         renderpassInfo.attachmentCount = 1;
         renderpassInfo.pAttachments = &colorAttachment;
         renderpassInfo.subpassCount = 1;
         renderpassInfo.pSubpasses = &subpass;
+        renderpassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+        renderpassInfo.pDependencies = dependencies.data();
 
         try {
             return vDevice.createRenderPass(renderpassInfo);
@@ -402,15 +918,41 @@ namespace tv {
     }
 
     structures::VGraphicsPipelineBundle Renderer::createGraphicsPipeline(structures::VGraphicsPipelineInBundle& vPipelineInBundle) const noexcept {
+        const ReflectedLayout reflectedLayout = createReflectedLayout({ vPipelineInBundle.vertexFilepath, vPipelineInBundle.fragmentFilepath });
+        vk::PipelineLayout pipelineLayout = reflectedLayout.layout;
+
+        vk::RenderPass renderpass = nullptr;
+        if (!vPipelineInBundle.dynamicRendering)
+            renderpass = createRenderpass(vPipelineInBundle.device, vPipelineInBundle.swapchainImageFormat, vPipelineInBundle.finalLayout);
+
+        structures::VGraphicsPipelineBundle pipelineBundle;
+        // frames bind set 0 only
+        pipelineBundle.descriptorSetLayout = reflectedLayout.setLayouts.empty() ? nullptr : reflectedLayout.setLayouts[0];
+        pipelineBundle.layout = pipelineLayout;
+        pipelineBundle.renderpass = renderpass;
+        pipelineBundle.handle = _pipelineManager->request([this, vPipelineInBundle, pipelineLayout, renderpass]() {
+            return compileGraphicsPipeline(vPipelineInBundle, pipelineLayout, renderpass);
+        });
+        pipelineBundle.pipeline = nullptr;
+
+        return pipelineBundle;
+    }
+
+    vk::Pipeline Renderer::compileGraphicsPipeline(const structures::VGraphicsPipelineInBundle& vPipelineInBundle, vk::PipelineLayout vPipelineLayout, vk::RenderPass vRenderpass) const noexcept {
         vk::GraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.flags = vk::PipelineCreateFlags();
 
         std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
 
+        // from the vertex shader's declared inputs, none for shaders that read storage buffers instead
+        const std::optional<shader::Reflection> vertexReflection = _shaderLibrary->getReflection(vPipelineInBundle.vertexFilepath);
+        const ReflectedVertexInput vertexInput = vertexReflection ? LayoutCache::getVertexInput(vertexReflection.value()) : ReflectedVertexInput{};
         vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
         vertexInputInfo.flags = vk::PipelineVertexInputStateCreateFlags();
-        vertexInputInfo.vertexBindingDescriptionCount = 0;
-        vertexInputInfo.vertexAttributeDescriptionCount = 0;
+        vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexInput.bindings.size());
+        vertexInputInfo.pVertexBindingDescriptions = vertexInput.bindings.data();
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInput.attributes.size());
+        vertexInputInfo.pVertexAttributeDescriptions = vertexInput.attributes.data();
         pipelineInfo.pVertexInputState = &vertexInputInfo;
 
         vk::PipelineInputAssemblyStateCreateInfo inputAssemblyInfo{};
@@ -418,7 +960,8 @@ namespace tv {
         inputAssemblyInfo.topology = vk::PrimitiveTopology::eTriangleList;
         pipelineInfo.pInputAssemblyState = &inputAssemblyInfo;
 
-        vk::ShaderModule vertexShader = createShaderModule(vPipelineInBundle.vertexFilepath, vPipelineInBundle.device);
+        // owned by the shader library, which keeps them for the next pipeline built from the same files
+        vk::ShaderModule vertexShader = _shaderLibrary->get(vPipelineInBundle.vertexFilepath);
         vk::PipelineShaderStageCreateInfo vertexShaderInfo{};
         vertexShaderInfo.flags = vk::PipelineShaderStageCreateFlags();
         vertexShaderInfo.stage = vk::ShaderStageFlagBits::eVertex;
@@ -426,27 +969,22 @@ namespace tv {
         vertexShaderInfo.pName = constants::config::VULKAN_SHADER_ENTRY_POINT_NAME;
         shaderStages.push_back(vertexShaderInfo);
 
-        vk::Viewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = static_cast<float>(vPipelineInBundle.swapchainExtent.width);
-        viewport.height = static_cast<float>(vPipelineInBundle.swapchainExtent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-
-        vk::Rect2D scissor{};
-        scissor.offset.x = 0;
-        scissor.offset.y = 0;
-        scissor.extent = vPipelineInBundle.swapchainExtent;
-
+        // set while recording, so a resize never invalidates the pipeline
         vk::PipelineViewportStateCreateInfo viewportState = {};
         viewportState.flags = vk::PipelineViewportStateCreateFlags();
         viewportState.viewportCount = 1;
-        viewportState.pViewports = &viewport;
+        viewportState.pViewports = nullptr;
         viewportState.scissorCount = 1;
-        viewportState.pScissors = &scissor;
+        viewportState.pScissors = nullptr;
         pipelineInfo.pViewportState = &viewportState;
 
+        const std::array<vk::DynamicState, 2> dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+        vk::PipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.flags = vk::PipelineDynamicStateCreateFlags();
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates = dynamicStates.data();
+        pipelineInfo.pDynamicState = &dynamicState;
+
         vk::PipelineRasterizationStateCreateInfo rasterizer{};
         rasterizer.flags = vk::PipelineRasterizationStateCreateFlags();
         rasterizer.depthClampEnable = VK_FALSE;
@@ -458,7 +996,7 @@ namespace tv {
         rasterizer.depthBiasEnable = VK_FALSE;
         pipelineInfo.pRasterizationState = &rasterizer;
 
-        vk::ShaderModule fragmentShader = createShaderModule(vPipelineInBundle.fragmentFilepath, vPipelineInBundle.device);
+        vk::ShaderModule fragmentShader = _shaderLibrary->get(vPipelineInBundle.fragmentFilepath);
         vk::PipelineShaderStageCreateInfo fragmentShaderInfo{};
         fragmentShaderInfo.flags = vk::PipelineShaderStageCreateFlags();
         fragmentShaderInfo.stage = vk::ShaderStageFlagBits::eFragment;
@@ -491,59 +1029,112 @@ namespace tv {
         colorBlending.blendConstants[3] = 0.0f;
         pipelineInfo.pColorBlendState = &colorBlending;
 
-        vk::PipelineLayout pipelineLayout = createPipelineLayout(vPipelineInBundle.device);
-        pipelineInfo.layout = pipelineLayout;
+        pipelineInfo.layout = vPipelineLayout;
 
-        vk::RenderPass renderpass = createRenderpass(vPipelineInBundle.device, vPipelineInBundle.swapchainImageFormat);
-        pipelineInfo.renderPass = renderpass;
+        vk::PipelineRenderingCreateInfo renderingInfo{};
+        if (vPipelineInBundle.dynamicRendering) {
+            renderingInfo.colorAttachmentCount = 1;
+            renderingInfo.pColorAttachmentFormats = &vPipelineInBundle.swapchainImageFormat;
+            pipelineInfo.pNext = &renderingInfo;
+        }
+        pipelineInfo.renderPass = vRenderpass;
         pipelineInfo.subpass = 0;
 
         pipelineInfo.basePipelineHandle = nullptr;
 
+        if (!vertexShader || !fragmentShader)
+            return nullptr;
+
 #if(TV_DEBUG_MODE)
         Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_GRAPHICS_PIPELINE_CREATION_STARTED));
 #endif
-        vk::Pipeline graphicsPipeline;
         try {
-            graphicsPipeline = (vPipelineInBundle.device.createGraphicsPipeline(nullptr, pipelineInfo)).value;
+            return (vPipelineInBundle.device.createGraphicsPipeline(vPipelineInBundle.pipelineCache, pipelineInfo)).value;
         } catch ([[maybe_unused]] const vk::SystemError& err) {
 #if(TV_DEBUG_MODE)
             Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_PIPELINE_CREATION_FAILED, err.what()));
 #endif
-            return {};
         }
 
-        structures::VGraphicsPipelineBundle pipelineBundle;
-        pipelineBundle.layout = pipelineLayout;
-        pipelineBundle.renderpass = renderpass;
-        pipelineBundle.pipeline = graphicsPipeline;
+        return nullptr;
+    }
+
+    structures::VComputePipelineBundle Renderer::createCullPipeline(vk::Device& vDevice) const noexcept {
+        structures::VComputePipelineInBundle pipelineInBundle = makeCullPipelineInBundle(vDevice);
+        structures::VComputePipelineBundle pipelineBundle = createComputePipeline(pipelineInBundle);
+        return pipelineBundle;
+    }
+
+    structures::VComputePipelineBundle Renderer::createComputePipeline(structures::VComputePipelineInBundle& vPipelineInBundle) const noexcept {
+        const ReflectedLayout reflectedLayout = createReflectedLayout({ vPipelineInBundle.computeFilepath });
+        vk::PipelineLayout pipelineLayout = reflectedLayout.layout;
 
-        vPipelineInBundle.device.destroyShaderModule(vertexShader);
-        vPipelineInBundle.device.destroyShaderModule(fragmentShader);
+        structures::VComputePipelineBundle pipelineBundle;
+        pipelineBundle.descriptorSetLayout = reflectedLayout.setLayouts.empty() ? nullptr : reflectedLayout.setLayouts[0];
+        pipelineBundle.layout = pipelineLayout;
+        pipelineBundle.handle = _pipelineManager->request([this, vPipelineInBundle, pipelineLayout]() {
+            return compileComputePipeline(vPipelineInBundle, pipelineLayout);
+        });
+        pipelineBundle.pipeline = nullptr;
 
         return pipelineBundle;
     }
 
-    void Renderer::createFramebuffers(vk::Device& vDevice, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle) const noexcept {
-        structures::VFramebufferInput frameBufferInput;
-        frameBufferInput.device = vDevice;
-        frameBufferInput.renderpass = vGraphicsPipelineBundle.renderpass;
-        frameBufferInput.swapchainExtent = vSwapChainBundle.extent;
+    vk::Pipeline Renderer::compileComputePipeline(const structures::VComputePipelineInBundle& vPipelineInBundle, vk::PipelineLayout vPipelineLayout) const noexcept {
+        vk::ShaderModule computeShader = _shaderLibrary->get(vPipelineInBundle.computeFilepath);
+        if (!computeShader)
+            return nullptr;
 
-        for (auto& frame : vSwapChainBundle.frames) {
-            std::vector<vk::ImageView> attachments = { frame.imageView };
+        vk::PipelineShaderStageCreateInfo computeShaderInfo{};
+        computeShaderInfo.flags = vk::PipelineShaderStageCreateFlags();
+        computeShaderInfo.stage = vk::ShaderStageFlagBits::eCompute;
+        computeShaderInfo.module = computeShader;
+        computeShaderInfo.pName = constants::config::VULKAN_SHADER_ENTRY_POINT_NAME;
 
-            vk::FramebufferCreateInfo framebufferInfo;
-            framebufferInfo.flags = vk::FramebufferCreateFlags();
-            framebufferInfo.renderPass = frameBufferInput.renderpass;
-            framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-            framebufferInfo.pAttachments = attachments.data();
-            framebufferInfo.width = frameBufferInput.swapchainExtent.width;
-            framebufferInfo.height = frameBufferInput.swapchainExtent.height;
-            framebufferInfo.layers = 1;
+        vk::ComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.flags = vk::PipelineCreateFlags();
+        pipelineInfo.stage = computeShaderInfo;
+        pipelineInfo.layout = vPipelineLayout;
+        pipelineInfo.basePipelineHandle = nullptr;
+
+#if(TV_DEBUG_MODE)
+        Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_COMPUTE_PIPELINE_CREATION_STARTED));
+#endif
+        try {
+            return (vPipelineInBundle.device.createComputePipeline(vPipelineInBundle.pipelineCache, pipelineInfo)).value;
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_PIPELINE_CREATION_FAILED, err.what()));
+#endif
+        }
+
+        return nullptr;
+    }
+
+    void Renderer::createFramebuffers(vk::Device& vDevice, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle) const noexcept {
+        structures::VFramebufferInput frameBufferInput;
+        frameBufferInput.device = vDevice;
+        frameBufferInput.renderpass = vGraphicsPipelineBundle.renderpass;
+        frameBufferInput.swapchainExtent = vSwapChainBundle.extent;
+
+        // dynamic rendering binds image views directly
+        if (!frameBufferInput.renderpass)
+            return;
+
+        for (auto& image : vSwapChainBundle.images) {
+            std::vector<vk::ImageView> attachments = { image.imageView };
+
+            vk::FramebufferCreateInfo framebufferInfo;
+            framebufferInfo.flags = vk::FramebufferCreateFlags();
+            framebufferInfo.renderPass = frameBufferInput.renderpass;
+            framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+            framebufferInfo.pAttachments = attachments.data();
+            framebufferInfo.width = frameBufferInput.swapchainExtent.width;
+            framebufferInfo.height = frameBufferInput.swapchainExtent.height;
+            framebufferInfo.layers = 1;
 
             try {
-                frame.framebuffer = frameBufferInput.device.createFramebuffer(framebufferInfo);
+                image.framebuffer = frameBufferInput.device.createFramebuffer(framebufferInfo);
 #if(TV_DEBUG_MODE)
                 Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_FRAMEBUFFER_CREATED));
 #endif
@@ -555,15 +1146,13 @@ namespace tv {
         }
     }
 
-    vk::CommandPool Renderer::createCommandPool(vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept {
+    vk::CommandPool Renderer::createCommandPool(vk::Device& vDevice, uint32_t queueFamilyIndex, vk::CommandPoolCreateFlags vFlags) const noexcept {
 #if(TV_DEBUG_MODE)
         Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_COMMAND_POOL_CREATION_STARTED));
 #endif
-        structures::VQueueFamilyIndices queueFamilyIndices = findQueueFamilies(vPhysicalDevice, vSurface);
-
         vk::CommandPoolCreateInfo poolInfo;
-        poolInfo.flags = vk::CommandPoolCreateFlags() | vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
-        poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+        poolInfo.flags = vFlags;
+        poolInfo.queueFamilyIndex = queueFamilyIndex;
 
         try {
             return vDevice.createCommandPool(poolInfo);
@@ -594,6 +1183,50 @@ namespace tv {
         }
     }
 
+    void Renderer::createFrameTransferCommandBuffers(structures::VCommandBufferInput& vInputChunk) const noexcept {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.commandPool = vInputChunk.commandPool;
+        allocInfo.level = vk::CommandBufferLevel::ePrimary;
+        allocInfo.commandBufferCount = 1;
+
+        for (auto& frame : vInputChunk.frames) {
+            try {
+                frame.transferCommandBuffer = vInputChunk.device.allocateCommandBuffers(allocInfo)[0];
+            } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_COMMAND_BUFFER_ALLOCATION_FAILED, err.what()));
+#endif
+                return;
+            }
+        }
+    }
+
+    void Renderer::createFrameWorkerCommandBuffers(vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface, std::vector<structures::VFrame>& vFrames, std::size_t workerCount) const noexcept {
+        // one pool per worker per frame so workers never share a pool and can reset it wholesale
+        const structures::VQueueFamilyIndices queueFamilyIndices = findQueueFamilies(vPhysicalDevice, vSurface);
+        for (auto& frame : vFrames) {
+            frame.workerCommandPools.resize(workerCount);
+            frame.workerCommandBuffers.resize(workerCount);
+            for (std::size_t i = 0; i < workerCount; ++i) {
+                frame.workerCommandPools[i] = createCommandPool(vDevice, queueFamilyIndices.graphicsFamily.value(), vk::CommandPoolCreateFlagBits::eTransient);
+
+                vk::CommandBufferAllocateInfo allocInfo{};
+                allocInfo.commandPool = frame.workerCommandPools[i];
+                allocInfo.level = vk::CommandBufferLevel::eSecondary;
+                allocInfo.commandBufferCount = 1;
+
+                try {
+                    frame.workerCommandBuffers[i] = vDevice.allocateCommandBuffers(allocInfo)[0];
+                } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                    Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_SECONDARY_COMMAND_BUFFER_ALLOCATION_FAILED, err.what()));
+#endif
+                    return;
+                }
+            }
+        }
+    }
+
     [[nodiscard]] vk::CommandBuffer Renderer::createCommandBuffer(structures::VCommandBufferInput& vInputChunk) const noexcept {
         vk::CommandBufferAllocateInfo allocInfo{};
         allocInfo.commandPool = vInputChunk.commandPool;
@@ -622,18 +1255,72 @@ namespace tv {
         }
     }
 
-    vk::Fence Renderer::createFence(vk::Device& vDevice) const noexcept {
-        vk::FenceCreateInfo fenceInfo{};
-        fenceInfo.flags = vk::FenceCreateFlags() | vk::FenceCreateFlagBits::eSignaled;
+    vk::QueryPool Renderer::createTimestampQueryPool(vk::Device& vDevice) const noexcept {
+        if (_vTimestampPeriod <= 0.0f)
+            return nullptr;
+
+        vk::QueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.flags = vk::QueryPoolCreateFlags();
+        queryPoolInfo.queryType = vk::QueryType::eTimestamp;
+        queryPoolInfo.queryCount = timestampQueryCount;
+
+        try {
+            return vDevice.createQueryPool(queryPoolInfo);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_QUERY_POOL_CREATION_FAILED, err.what()));
+#endif
+        }
+
+        return nullptr;
+    }
+
+    double Renderer::readGpuTime(structures::VFrame& vFrame) const noexcept {
+        if (!vFrame.timestampQueryPool || !vFrame.timestampsWritten)
+            return 0.0;
+
+        try {
+            const auto timestamps = _vDevice.getQueryPoolResults<uint64_t>(
+                vFrame.timestampQueryPool,
+                0,
+                timestampQueryCount,
+                timestampQueryCount * sizeof(uint64_t),
+                sizeof(uint64_t),
+                vk::QueryResultFlagBits::e64
+            );
+            if (timestamps.result != vk::Result::eSuccess)
+                return 0.0;
+
+            // masking the difference as well keeps it right when the counter wrapped between the two writes
+            const uint64_t begin = timestamps.value[0] & _vTimestampMask;
+            const uint64_t end = timestamps.value[1] & _vTimestampMask;
+            return static_cast<double>((end - begin) & _vTimestampMask) * _vTimestampPeriod / 1e6;
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+        }
+
+        return 0.0;
+    }
+
+    vk::Semaphore Renderer::createTimelineSemaphore(vk::Device& vDevice) const noexcept {
+        vk::SemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+        typeInfo.initialValue = 0;
+
+        vk::SemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.flags = vk::SemaphoreCreateFlags();
+        semaphoreInfo.pNext = &typeInfo;
 
         try {
-            return vDevice.createFence(fenceInfo);
+            return vDevice.createSemaphore(semaphoreInfo);
         } catch (const vk::SystemError&) {
             return nullptr;
         }
     }
 
-    structures::VSwapChainBundle Renderer::createSwapchain(GLFWwindow* window, vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface, std::size_t& vMaxFramesInFlight) const noexcept {
+    structures::VSwapChainBundle Renderer::createSwapchain(GLFWwindow* window, vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface, vk::SwapchainKHR vOldSwapchain) const noexcept {
 #if(TV_DEBUG_MODE)
         Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_SWAPCHAIN_CREATION_STARTED));
 #endif
@@ -676,7 +1363,8 @@ namespace tv {
         createInfo.presentMode = presentMode;
         createInfo.clipped = VK_TRUE;
 
-        createInfo.oldSwapchain = nullptr;
+        // lets the driver hand over resources and keep presenting the old images meanwhile
+        createInfo.oldSwapchain = vOldSwapchain;
 
         structures::VSwapChainBundle bundle;
         try {
@@ -688,7 +1376,7 @@ namespace tv {
         }
 
         const std::vector<vk::Image> images = vDevice.getSwapchainImagesKHR(bundle.swapChain);
-        bundle.frames.reserve(images.size());
+        bundle.images.reserve(images.size());
         for (size_t i = 0; i < images.size(); ++i) {
             vk::ImageViewCreateInfo imageViewCreateInfo{};
             imageViewCreateInfo.image = images[i];
@@ -705,83 +1393,341 @@ namespace tv {
             imageViewCreateInfo.subresourceRange.layerCount = 1;
             imageViewCreateInfo.format = format.format;
 
-            bundle.frames.emplace_back(structures::VSwapChainFrame{
-                images[i],
-                vDevice.createImageView(imageViewCreateInfo),
-                nullptr,
-                nullptr,
-                {},
-                {},
-                {}
-            });
+            structures::VSwapChainImage image{};
+            image.image = images[i];
+            image.imageView = vDevice.createImageView(imageViewCreateInfo);
+            bundle.images.push_back(image);
         }
 
         bundle.format = format.format;
         bundle.extent = extent;
 
-        vMaxFramesInFlight = bundle.frames.size();
+        return bundle;
+    }
+
+    structures::VSwapChainBundle Renderer::createOffscreenTargets(vk::Device& vDevice, vk::Extent2D extent, std::size_t imageCount) const noexcept {
+#if(TV_DEBUG_MODE)
+        Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_OFFSCREEN_TARGETS_CREATION_STARTED));
+#endif
+        structures::VSwapChainBundle bundle;
+        bundle.swapChain = nullptr;
+        bundle.format = offscreenFormat;
+        bundle.extent = extent;
+
+        const vk::DeviceSize readbackSize = static_cast<vk::DeviceSize>(extent.width) * extent.height * offscreenPixelSize;
+        bundle.images.resize(imageCount);
+        for (auto& image : bundle.images) {
+            vk::ImageCreateInfo imageInfo{};
+            imageInfo.flags = vk::ImageCreateFlags();
+            imageInfo.imageType = vk::ImageType::e2D;
+            imageInfo.format = offscreenFormat;
+            imageInfo.extent = vk::Extent3D{ extent.width, extent.height, 1 };
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.samples = vk::SampleCountFlagBits::e1;
+            imageInfo.tiling = vk::ImageTiling::eOptimal;
+            imageInfo.usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc;
+            imageInfo.sharingMode = vk::SharingMode::eExclusive;
+            imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+
+            try {
+                image.image = vDevice.createImage(imageInfo);
+
+                const vk::MemoryRequirements requirements = vDevice.getImageMemoryRequirements(image.image);
+                image.imageAllocation = _memoryAllocator->allocate(requirements, vk::MemoryPropertyFlagBits::eDeviceLocal, AllocationTiling::optimal);
+                vDevice.bindImageMemory(image.image, image.imageAllocation.memory, image.imageAllocation.offset);
+            } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_IMAGE_CREATION_FAILED, err.what()));
+#endif
+                return bundle;
+            }
+
+            vk::ImageViewCreateInfo imageViewCreateInfo{};
+            imageViewCreateInfo.image = image.image;
+            imageViewCreateInfo.viewType = vk::ImageViewType::e2D;
+            imageViewCreateInfo.format = offscreenFormat;
+            imageViewCreateInfo.components.r = vk::ComponentSwizzle::eIdentity;
+            imageViewCreateInfo.components.g = vk::ComponentSwizzle::eIdentity;
+            imageViewCreateInfo.components.b = vk::ComponentSwizzle::eIdentity;
+            imageViewCreateInfo.components.a = vk::ComponentSwizzle::eIdentity;
+            imageViewCreateInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+            imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+            imageViewCreateInfo.subresourceRange.levelCount = 1;
+            imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+            imageViewCreateInfo.subresourceRange.layerCount = 1;
+            image.imageView = vDevice.createImageView(imageViewCreateInfo);
+
+            image.readbackBuffer = createBuffer(
+                vDevice,
+                readbackSize,
+                vk::BufferUsageFlagBits::eTransferDst,
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+            );
+        }
 
         return bundle;
     }
 
     void Renderer::resetSwapchain() noexcept {
-        std::ranges::for_each(_vSwapChainBundle.frames, [this](structures::VSwapChainFrame& frame) {
-            _vDevice.destroyImageView(frame.imageView);
-            _vDevice.destroyFramebuffer(frame.framebuffer);
+        releaseSwapchainImages(_vSwapChainBundle.images);
+        _vDevice.destroySwapchainKHR(_vSwapChainBundle.swapChain);
+        destroyRetiredSwapchains(std::numeric_limits<uint64_t>::max());
+
+        for (vk::Semaphore semaphore : _vSpareSemaphores)
+            _vDevice.destroySemaphore(semaphore);
+        _vSpareSemaphores.clear();
+    }
+
+    void Renderer::releaseSwapchainImages(std::vector<structures::VSwapChainImage>& vImages) noexcept {
+        std::ranges::for_each(vImages, [this](structures::VSwapChainImage& image) {
+            _vDevice.destroyImageView(image.imageView);
+
+            // swapchain images belong to the swapchain, only offscreen targets own their memory
+            if (image.imageAllocation.block) {
+                _vDevice.destroyImage(image.image);
+                _memoryAllocator->free(image.imageAllocation);
+            }
+            _vDevice.destroyFramebuffer(image.framebuffer);
+            destroyBuffer(_vDevice, image.readbackBuffer);
+
+            if (image.renderFinished)
+                _vSpareSemaphores.push_back(image.renderFinished);
+        });
 
-            _vDevice.destroyFence(frame.inFlight);
+        vImages.clear();
+    }
+
+    void Renderer::destroyRetiredSwapchains(uint64_t completedFrame) noexcept {
+        std::erase_if(_vRetiredSwapchains, [this, completedFrame](structures::VRetiredSwapchain& retired) {
+            if (retired.retireValue > completedFrame)
+                return false;
+
+            releaseSwapchainImages(retired.images);
+            _vDevice.destroySwapchainKHR(retired.swapChain);
+            return true;
+        });
+    }
+
+    void Renderer::destroyFrames() noexcept {
+        std::ranges::for_each(_vFrames, [this](structures::VFrame& frame) {
+            for (auto& commandPool : frame.workerCommandPools)
+                _vDevice.destroyCommandPool(commandPool);
+
+            _vDevice.destroyQueryPool(frame.timestampQueryPool);
             _vDevice.destroySemaphore(frame.imageAvailable);
-            _vDevice.destroySemaphore(frame.renderFinished);
+            _vDevice.destroySemaphore(frame.uploadFinished);
+
+            destroyBuffer(_vDevice, frame.instanceBuffer);
+            destroyBuffer(_vDevice, frame.visibleBuffer);
+            destroyBuffer(_vDevice, frame.drawBuffer);
         });
+    }
 
-        _vDevice.destroySwapchainKHR(_vSwapChainBundle.swapChain);
+    vk::PipelineCache Renderer::createPipelineCache(vk::Device& vDevice, const vk::PhysicalDevice& vPhysicalDevice) const noexcept {
+        // the cache blob is handed to the driver from the mapping, it must outlive pipeline cache creation
+        service::MappedFile file{};
+        std::span<const char> initialData;
+        const std::filesystem::path cachePath = service::FileService::getExecutableDirectory() / constants::path::PIPELINE_CACHE_FILE;
+        if (std::filesystem::exists(cachePath)) {
+            file = service::FileService::map(cachePath.string());
+
+            structures::VPipelineCacheHeader header{};
+            if (file.size() >= sizeof(header))
+                std::memcpy(&header, file.data(), sizeof(header));
+
+            const structures::VPipelineCacheHeader expected = makePipelineCacheHeader(vPhysicalDevice, file.size() - std::min(file.size(), sizeof(header)));
+            if (file.size() > sizeof(header) && std::memcmp(&header, &expected, sizeof(header)) == 0) {
+                initialData = file.getSpan().subspan(sizeof(header));
+#if(TV_DEBUG_MODE)
+                Logger::instance().log(std::format("{}: {} bytes\n", constants::messages::VULKAN_PIPELINE_CACHE_LOADED, initialData.size()));
+#endif
+            } else {
+                Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_PIPELINE_CACHE_REJECTED));
+            }
+        }
+
+        vk::PipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.flags = vk::PipelineCacheCreateFlags();
+        cacheInfo.initialDataSize = initialData.size();
+        cacheInfo.pInitialData = initialData.data();
+
+        try {
+            return vDevice.createPipelineCache(cacheInfo);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_PIPELINE_CACHE_CREATION_FAILED, err.what()));
+#endif
+        }
+
+        return nullptr;
+    }
+
+    void Renderer::savePipelineCache(vk::Device& vDevice, const vk::PhysicalDevice& vPhysicalDevice, vk::PipelineCache vPipelineCache) const noexcept {
+        if (!vPipelineCache)
+            return;
+
+        std::vector<uint8_t> data;
+        try {
+            data = vDevice.getPipelineCacheData(vPipelineCache);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+            return;
+        }
+
+        const structures::VPipelineCacheHeader header = makePipelineCacheHeader(vPhysicalDevice, data.size());
+        std::vector<char> file(sizeof(header) + data.size());
+        std::memcpy(file.data(), &header, sizeof(header));
+        std::memcpy(file.data() + sizeof(header), data.data(), data.size());
+
+        const std::filesystem::path cachePath = service::FileService::getExecutableDirectory() / constants::path::PIPELINE_CACHE_FILE;
+        if (service::FileService::writeAtomically(cachePath.string(), file)) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().log(std::format("{}: {} bytes\n", constants::messages::VULKAN_PIPELINE_CACHE_SAVED, data.size()));
+#endif
+        }
+    }
+
+    structures::VPipelineCacheHeader Renderer::makePipelineCacheHeader(const vk::PhysicalDevice& vPhysicalDevice, uint64_t dataSize) const noexcept {
+        const vk::PhysicalDeviceProperties properties = vPhysicalDevice.getProperties();
+
+        structures::VPipelineCacheHeader header{};
+        header.magic = constants::config::VULKAN_PIPELINE_CACHE_MAGIC;
+        header.vendorID = properties.vendorID;
+        header.deviceID = properties.deviceID;
+        header.driverVersion = properties.driverVersion;
+        std::ranges::copy(properties.pipelineCacheUUID, header.pipelineCacheUUID);
+        header.dataSize = dataSize;
+
+        return header;
     }
 
     structures::VGraphicsPipelineBundle Renderer::createPipeline(vk::Device& vDevice, structures::VSwapChainBundle& vSwapchainBundle) const noexcept {
+        structures::VGraphicsPipelineInBundle pipelineInBundle = makeGraphicsPipelineInBundle(vDevice, vSwapchainBundle.format);
+        structures::VGraphicsPipelineBundle pipelineBundle = createGraphicsPipeline(pipelineInBundle);
+        return pipelineBundle;
+    }
+
+    structures::VGraphicsPipelineInBundle Renderer::makeGraphicsPipelineInBundle(vk::Device& vDevice, vk::Format vSwapchainImageFormat) const noexcept {
         structures::VGraphicsPipelineInBundle pipelineInBundle{};
         pipelineInBundle.device = vDevice;
+        pipelineInBundle.pipelineCache = _vPipelineCache;
         pipelineInBundle.vertexFilepath = constants::path::TRIANGLE_VERTEX_PATH.string();
         pipelineInBundle.fragmentFilepath = constants::path::TRIANGLE_FRAGMENT_PATH.string();
-        pipelineInBundle.swapchainExtent = vSwapchainBundle.extent;
-        pipelineInBundle.swapchainImageFormat = vSwapchainBundle.format;
+        pipelineInBundle.swapchainImageFormat = vSwapchainImageFormat;
+        // headless targets are copied out for the caller instead of being presented
+        pipelineInBundle.finalLayout = headless() ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR;
+        pipelineInBundle.dynamicRendering = _vDynamicRendering;
 
-        structures::VGraphicsPipelineBundle pipelineBundle = createGraphicsPipeline(pipelineInBundle);
-        return pipelineBundle;
+        return pipelineInBundle;
+    }
+
+    structures::VComputePipelineInBundle Renderer::makeCullPipelineInBundle(vk::Device& vDevice) const noexcept {
+        structures::VComputePipelineInBundle pipelineInBundle{};
+        pipelineInBundle.device = vDevice;
+        pipelineInBundle.pipelineCache = _vPipelineCache;
+        pipelineInBundle.computeFilepath = constants::path::CULL_COMPUTE_PATH.string();
+
+        return pipelineInBundle;
+    }
+
+    void Renderer::reloadShaders() noexcept {
+        // modules replaced by a reload are destroyed, so nothing may be compiling from them meanwhile
+        if (_pipelineManager->isCompiling())
+            return;
+
+        const std::vector<std::string> changed = _shaderLibrary->reload();
+        if (changed.empty())
+            return;
+
+        const auto uses = [&changed](const std::filesystem::path& filePath) {
+            return std::ranges::find(changed, filePath.string()) != changed.end();
+        };
+
+        // only the pipelines built from a changed file are recompiled, layouts and the render pass are kept
+        if (uses(constants::path::TRIANGLE_VERTEX_PATH) || uses(constants::path::TRIANGLE_FRAGMENT_PATH))
+            _pipelineManager->rebuild(_vGraphicsPipelineBundle.handle);
+
+        if (_vGpuCulling && uses(constants::path::CULL_COMPUTE_PATH))
+            _pipelineManager->rebuild(_vCullPipelineBundle.handle);
     }
 
-    void Renderer::finalSetup(vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR vSurface, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, vk::CommandPool& vCommandPool, vk::CommandBuffer vMainCommandBuffer) const noexcept {
+    void Renderer::updatePipelines() noexcept {
+        _pipelineManager->update(_vSubmittedFrame);
+
+        const auto refresh = [this](vk::Pipeline& vPipeline, PipelineHandle handle) {
+            const vk::Pipeline vCurrent = _pipelineManager->get(handle);
+#if(TV_DEBUG_MODE)
+            if (vPipeline && vCurrent != vPipeline)
+                Logger::instance().log(std::format("{}\n", constants::messages::VULKAN_PIPELINE_REBUILT));
+#endif
+            vPipeline = vCurrent;
+        };
+        refresh(_vGraphicsPipelineBundle.pipeline, _vGraphicsPipelineBundle.handle);
+        if (_vGpuCulling)
+            refresh(_vCullPipelineBundle.pipeline, _vCullPipelineBundle.handle);
+    }
+
+    void Renderer::finalSetup(vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR vSurface, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, std::vector<structures::VFrame>& vFrames, vk::CommandPool& vCommandPool, vk::CommandBuffer vMainCommandBuffer) noexcept {
         createFramebuffers(vDevice, vGraphicsPipelineBundle, vSwapChainBundle);
 
-        vCommandPool = createCommandPool(vDevice, vPhysicalDevice, vSurface);
+        const structures::VQueueFamilyIndices queueFamilyIndices = findQueueFamilies(vPhysicalDevice, vSurface);
+        vCommandPool = createCommandPool(vDevice, queueFamilyIndices.graphicsFamily.value(), vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
 
-        structures::VCommandBufferInput commandBufferInput = { vDevice, vCommandPool, vSwapChainBundle.frames };
+        structures::VCommandBufferInput commandBufferInput = { vDevice, vCommandPool, vFrames };
         vMainCommandBuffer = createCommandBuffer(commandBufferInput);
         createFrameCommandBuffers(commandBufferInput);
+        createFrameWorkerCommandBuffers(vDevice, vPhysicalDevice, vSurface, vFrames, JobSystem::instance().getWorkerCount());
 
-        createFrameSyncObjects(vDevice, vSwapChainBundle);
+        createFrameSyncObjects(vDevice, vFrames);
+        createImageSyncObjects(vDevice, vSwapChainBundle);
     }
 
     void Renderer::recreateSwapchain() noexcept {
         int windowWidth = 0;
         int windowHeight = 0;
-        while (windowWidth == 0 || windowHeight == 0) {
-            glfwGetFramebufferSize(_window, &windowWidth, &windowHeight);
-            glfwWaitEvents();
-        }
+        glfwGetFramebufferSize(_window, &windowWidth, &windowHeight);
 
-        _vDevice.waitIdle();
+        // minimized, retried by the next render once the window has an area again
+        _vSwapchainOutdated = windowWidth == 0 || windowHeight == 0;
+        if (_vSwapchainOutdated)
+            return;
 
-        resetSwapchain();
+        // no device wait: frames already submitted may still render to or present the old images,
+        // so they are retired and destroyed once the presentation engine has had a full round of frames to let go
+        _vRetiredSwapchains.push_back(structures::VRetiredSwapchain{
+            _vSwapChainBundle.swapChain,
+            std::move(_vSwapChainBundle.images),
+            _vSubmittedFrame + _vMaxFramesInFlight
+        });
 
-        _vSwapChainBundle = createSwapchain(_window, _vDevice, _vPhysicalDevice, _vSurface, _vMaxFramesInFlight);
+        // frames in flight and the pipeline do not depend on the swapchain, only per-image objects are rebuilt
+        _vSwapChainBundle = createSwapchain(_window, _vDevice, _vPhysicalDevice, _vSurface, _vRetiredSwapchains.back().swapChain);
         createFramebuffers(_vDevice, _vGraphicsPipelineBundle, _vSwapChainBundle);
-        createFrameSyncObjects(_vDevice, _vSwapChainBundle);
+        createImageSyncObjects(_vDevice, _vSwapChainBundle);
+    }
 
-        structures::VCommandBufferInput commandBufferInput = { _vDevice, _vCommandPool, _vSwapChainBundle.frames };
-        createFrameCommandBuffers(commandBufferInput);
+    void Renderer::recordFrame(structures::VFrame& vFrame, uint32_t imageIndex, const SceneSnapshot* snapshot, std::size_t maxChunkCount) noexcept {
+        const std::size_t instanceCount = snapshot->getInstanceCount();
+        const std::size_t chunkCount = std::clamp<std::size_t>(
+            (instanceCount + constants::config::VULKAN_MIN_RECORDING_CHUNK_SIZE - 1) / constants::config::VULKAN_MIN_RECORDING_CHUNK_SIZE,
+            1,
+            maxChunkCount
+        );
+
+        // command pools belong to chunks rather than threads, so whichever worker takes a chunk records it
+        JobSystem::instance().parallelFor(chunkCount, 1, [this, chunkCount, imageIndex, &vFrame, snapshot](std::size_t first, std::size_t last) {
+            for (std::size_t chunkIndex = first; chunkIndex < last; ++chunkIndex)
+                recordChunkCommands(chunkIndex, chunkCount, imageIndex, _vGraphicsPipelineBundle, _vSwapChainBundle, vFrame, snapshot);
+        });
+
+        vFrame.commandBuffer.reset();
+        recordDrawCommands(vFrame.commandBuffer, imageIndex, _vGraphicsPipelineBundle, _vCullPipelineBundle, _vSwapChainBundle, vFrame, snapshot, chunkCount);
     }
 
-    void Renderer::recordDrawCommands(vk::CommandBuffer &vCommandBuffer, uint32_t imageIndex, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, Scene* scene) const noexcept {
+    void Renderer::recordDrawCommands(vk::CommandBuffer &vCommandBuffer, uint32_t imageIndex, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VComputePipelineBundle& vCullPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, const structures::VFrame& vFrame, const SceneSnapshot* snapshot, std::size_t chunkCount) const noexcept {
         vk::CommandBufferBeginInfo beginInfo{};
 
         try {
@@ -793,29 +1739,94 @@ namespace tv {
             return;
         }
 
-        vk::RenderPassBeginInfo renderPassInfo{};
-        renderPassInfo.renderPass = vGraphicsPipelineBundle.renderpass;
-        renderPassInfo.framebuffer = vSwapChainBundle.frames[imageIndex].framebuffer;
-        renderPassInfo.renderArea.offset.x = 0;
-        renderPassInfo.renderArea.offset.y = 0;
-        renderPassInfo.renderArea.extent = vSwapChainBundle.extent;
+        // until it is compiled the draw is skipped as well, it would read a stale draw buffer
+        if (_vGpuCulling && vCullPipelineBundle.pipeline)
+            recordCullCommands(vCommandBuffer, vCullPipelineBundle, vFrame, snapshot);
 
+        const structures::VSwapChainImage& image = vSwapChainBundle.images[imageIndex];
         vk::ClearValue clearColor = { std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f} };
-        renderPassInfo.clearValueCount = 1;
-        renderPassInfo.pClearValues = &clearColor;
 
-        vCommandBuffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eInline);
-        vCommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, vGraphicsPipelineBundle.pipeline);
+        if (vFrame.timestampQueryPool) {
+            vCommandBuffer.resetQueryPool(vFrame.timestampQueryPool, 0, timestampQueryCount);
+            vCommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, vFrame.timestampQueryPool, 0);
+        }
+
+        if (_vDynamicRendering) {
+            // the layout transitions a render pass would do implicitly are spelled out around the rendering
+            recordImageBarrier(
+                vCommandBuffer,
+                image.image,
+                vk::ImageLayout::eUndefined,
+                vk::ImageLayout::eColorAttachmentOptimal,
+                vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                vk::AccessFlags(),
+                vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                vk::AccessFlagBits::eColorAttachmentWrite
+            );
 
-        for (const auto& position : scene->getPositions()) {
-            auto model = glm::translate(glm::mat4(1.0f), position);
-            shader::model::Triangle triangle;
-            triangle.model = model;
-            vCommandBuffer.pushConstants(vGraphicsPipelineBundle.layout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(triangle), &triangle);
-            vCommandBuffer.draw(3, 1, 0, 0);
+            vk::RenderingAttachmentInfo colorAttachment{};
+            colorAttachment.imageView = image.imageView;
+            colorAttachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+            colorAttachment.loadOp = vk::AttachmentLoadOp::eClear;
+            colorAttachment.storeOp = vk::AttachmentStoreOp::eStore;
+            colorAttachment.clearValue = clearColor;
+
+            vk::RenderingInfo renderingInfo{};
+            renderingInfo.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+            renderingInfo.renderArea.offset.x = 0;
+            renderingInfo.renderArea.offset.y = 0;
+            renderingInfo.renderArea.extent = vSwapChainBundle.extent;
+            renderingInfo.layerCount = 1;
+            renderingInfo.colorAttachmentCount = 1;
+            renderingInfo.pColorAttachments = &colorAttachment;
+
+            vCommandBuffer.beginRendering(renderingInfo);
+            vCommandBuffer.executeCommands(static_cast<uint32_t>(chunkCount), vFrame.workerCommandBuffers.data());
+            vCommandBuffer.endRendering();
+
+            if (headless()) {
+                recordImageBarrier(
+                    vCommandBuffer,
+                    image.image,
+                    vk::ImageLayout::eColorAttachmentOptimal,
+                    vk::ImageLayout::eTransferSrcOptimal,
+                    vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                    vk::AccessFlagBits::eColorAttachmentWrite,
+                    vk::PipelineStageFlagBits::eTransfer,
+                    vk::AccessFlagBits::eTransferRead
+                );
+            } else {
+                recordImageBarrier(
+                    vCommandBuffer,
+                    image.image,
+                    vk::ImageLayout::eColorAttachmentOptimal,
+                    vk::ImageLayout::ePresentSrcKHR,
+                    vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                    vk::AccessFlagBits::eColorAttachmentWrite,
+                    vk::PipelineStageFlagBits::eBottomOfPipe,
+                    vk::AccessFlags()
+                );
+            }
+        } else {
+            vk::RenderPassBeginInfo renderPassInfo{};
+            renderPassInfo.renderPass = vGraphicsPipelineBundle.renderpass;
+            renderPassInfo.framebuffer = image.framebuffer;
+            renderPassInfo.renderArea.offset.x = 0;
+            renderPassInfo.renderArea.offset.y = 0;
+            renderPassInfo.renderArea.extent = vSwapChainBundle.extent;
+            renderPassInfo.clearValueCount = 1;
+            renderPassInfo.pClearValues = &clearColor;
+
+            vCommandBuffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+            vCommandBuffer.executeCommands(static_cast<uint32_t>(chunkCount), vFrame.workerCommandBuffers.data());
+            vCommandBuffer.endRenderPass();
         }
 
-        vCommandBuffer.endRenderPass();
+        if (vFrame.timestampQueryPool)
+            vCommandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, vFrame.timestampQueryPool, 1);
+
+        if (image.readbackBuffer.buffer)
+            recordReadbackCommands(vCommandBuffer, image, vSwapChainBundle.extent);
 
         try {
             vCommandBuffer.end();
@@ -827,11 +1838,543 @@ namespace tv {
         }
     }
 
-    void Renderer::createFrameSyncObjects(vk::Device& vDevice, structures::VSwapChainBundle& vSwapChainBundle) const noexcept {
-        for (auto& frame : vSwapChainBundle.frames) {
-            frame.inFlight = createFence(vDevice);
+    void Renderer::recordChunkCommands(std::size_t chunkIndex, std::size_t chunkCount, uint32_t imageIndex, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, structures::VFrame& vFrame, const SceneSnapshot* snapshot) const noexcept {
+        const std::size_t instanceCount = snapshot->getInstanceCount();
+        const std::size_t firstInstance = instanceCount * chunkIndex / chunkCount;
+        const std::size_t lastInstance = instanceCount * (chunkIndex + 1) / chunkCount;
+
+        uploadInstances(vFrame, snapshot, firstInstance, lastInstance);
+
+        vk::CommandBuffer commandBuffer = vFrame.workerCommandBuffers[chunkIndex];
+
+        vk::CommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.renderPass = vGraphicsPipelineBundle.renderpass;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = vSwapChainBundle.images[imageIndex].framebuffer;
+
+        vk::CommandBufferInheritanceRenderingInfo inheritanceRenderingInfo{};
+        if (_vDynamicRendering) {
+            inheritanceRenderingInfo.colorAttachmentCount = 1;
+            inheritanceRenderingInfo.pColorAttachmentFormats = &vSwapChainBundle.format;
+            inheritanceRenderingInfo.rasterizationSamples = vk::SampleCountFlagBits::e1;
+            inheritanceInfo.pNext = &inheritanceRenderingInfo;
+        }
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        try {
+            _vDevice.resetCommandPool(vFrame.workerCommandPools[chunkIndex]);
+            commandBuffer.begin(beginInfo);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+            return;
+        }
+
+        // still compiling: the chunk stays empty and the frame shows the clear color only
+        if (!vGraphicsPipelineBundle.pipeline || (_vGpuCulling && !_vCullPipelineBundle.pipeline)) {
+            try {
+                commandBuffer.end();
+            } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+            }
+            return;
+        }
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, vGraphicsPipelineBundle.pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, vGraphicsPipelineBundle.layout, 0, vFrame.descriptorSet, nullptr);
+
+        // secondary command buffers inherit no dynamic state, every chunk sets its own
+        vk::Viewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(vSwapChainBundle.extent.width);
+        viewport.height = static_cast<float>(vSwapChainBundle.extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        commandBuffer.setViewport(0, viewport);
+
+        vk::Rect2D scissor{};
+        scissor.offset.x = 0;
+        scissor.offset.y = 0;
+        scissor.extent = vSwapChainBundle.extent;
+        commandBuffer.setScissor(0, scissor);
+
+        shader::model::Camera camera;
+        camera.viewProjection = snapshot->getViewProjection();
+        commandBuffer.pushConstants(vGraphicsPipelineBundle.layout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(camera), &camera);
+
+        if (_vGpuCulling) {
+            // the compacted list is built on the GPU, so a single indirect draw covers every chunk
+            if (chunkIndex == 0) {
+                commandBuffer.drawIndirectCount(
+                    vFrame.drawBuffer.buffer,
+                    0,
+                    vFrame.drawBuffer.buffer,
+                    offsetof(shader::model::DrawCommand, drawCount),
+                    1,
+                    sizeof(vk::DrawIndirectCommand)
+                );
+            }
+        } else {
+            // the CPU cull list is split between the chunks the same way the instances are
+            const uint32_t firstVisible = static_cast<uint32_t>(vFrame.visibleCount * chunkIndex / chunkCount);
+            const uint32_t lastVisible = static_cast<uint32_t>(vFrame.visibleCount * (chunkIndex + 1) / chunkCount);
+            if (lastVisible > firstVisible)
+                commandBuffer.draw(3, lastVisible - firstVisible, 0, firstVisible);
+        }
+
+        try {
+            commandBuffer.end();
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+            return;
+        }
+    }
+
+    void Renderer::recordImageBarrier(vk::CommandBuffer& vCommandBuffer, vk::Image vImage, vk::ImageLayout vOldLayout, vk::ImageLayout vNewLayout, vk::PipelineStageFlags vSrcStage, vk::AccessFlags vSrcAccess, vk::PipelineStageFlags vDstStage, vk::AccessFlags vDstAccess) const noexcept {
+        vk::ImageMemoryBarrier barrier{};
+        barrier.srcAccessMask = vSrcAccess;
+        barrier.dstAccessMask = vDstAccess;
+        barrier.oldLayout = vOldLayout;
+        barrier.newLayout = vNewLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = vImage;
+        barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        vCommandBuffer.pipelineBarrier(vSrcStage, vDstStage, vk::DependencyFlags(), nullptr, nullptr, barrier);
+    }
+
+    void Renderer::recordReadbackCommands(vk::CommandBuffer& vCommandBuffer, const structures::VSwapChainImage& vImage, vk::Extent2D extent) const noexcept {
+        // the render pass (or the closing barrier under dynamic rendering) leaves the target in eTransferSrcOptimal
+        // with its color writes made visible to this copy
+        vk::BufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = vk::Offset3D{ 0, 0, 0 };
+        region.imageExtent = vk::Extent3D{ extent.width, extent.height, 1 };
+        vCommandBuffer.copyImageToBuffer(vImage.image, vk::ImageLayout::eTransferSrcOptimal, vImage.readbackBuffer.buffer, region);
+
+        vk::MemoryBarrier readbackBarrier{};
+        readbackBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        readbackBarrier.dstAccessMask = vk::AccessFlagBits::eHostRead;
+        vCommandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eHost,
+            vk::DependencyFlags(),
+            readbackBarrier,
+            nullptr,
+            nullptr
+        );
+    }
+
+    void Renderer::recordCullCommands(vk::CommandBuffer& vCommandBuffer, structures::VComputePipelineBundle& vCullPipelineBundle, const structures::VFrame& vFrame, const SceneSnapshot* snapshot) const noexcept {
+        const shader::model::DrawCommand resetCommand{ 3, 0, 0, 0, 0 };
+        vCommandBuffer.updateBuffer(vFrame.drawBuffer.buffer, 0, sizeof(resetCommand), &resetCommand);
+
+        vk::MemoryBarrier resetBarrier{};
+        resetBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        resetBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+        vCommandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::DependencyFlags(),
+            resetBarrier,
+            nullptr,
+            nullptr
+        );
+
+        shader::model::Cull cull;
+        const Frustum frustum{ snapshot->getViewProjection() };
+        std::ranges::copy(frustum.getPlanes(), cull.planes);
+        cull.instanceCount = static_cast<uint32_t>(snapshot->getInstanceCount());
+        cull.radius = snapshot->getBoundingRadius();
+
+        vCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, vCullPipelineBundle.pipeline);
+        vCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, vCullPipelineBundle.layout, 0, vFrame.cullDescriptorSet, nullptr);
+        vCommandBuffer.pushConstants(vCullPipelineBundle.layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(cull), &cull);
+
+        constexpr uint32_t workgroupSize = constants::config::VULKAN_CULL_WORKGROUP_SIZE;
+        vCommandBuffer.dispatch((cull.instanceCount + workgroupSize - 1) / workgroupSize, 1, 1);
+
+        // the host reads the surviving instance count back once the frame completes
+        vk::MemoryBarrier cullBarrier{};
+        cullBarrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+        cullBarrier.dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eHostRead;
+        vCommandBuffer.pipelineBarrier(
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eHost,
+            vk::DependencyFlags(),
+            cullBarrier,
+            nullptr,
+            nullptr
+        );
+    }
+
+    void Renderer::createFrameSyncObjects(vk::Device& vDevice, std::vector<structures::VFrame>& vFrames) const noexcept {
+        for (auto& frame : vFrames) {
+            frame.timelineValue = 0;
             frame.imageAvailable = createSemaphore(vDevice);
-            frame.renderFinished = createSemaphore(vDevice);
+            frame.uploadFinished = createSemaphore(vDevice);
+            frame.timestampQueryPool = createTimestampQueryPool(vDevice);
+            frame.timestampsWritten = false;
+        }
+    }
+
+    void Renderer::createImageSyncObjects(vk::Device& vDevice, structures::VSwapChainBundle& vSwapChainBundle) noexcept {
+        for (auto& image : vSwapChainBundle.images) {
+            // semaphores of destroyed images are unsignalled by then and can be handed out again
+            if (_vSpareSemaphores.empty()) {
+                image.renderFinished = createSemaphore(vDevice);
+                continue;
+            }
+
+            image.renderFinished = _vSpareSemaphores.back();
+            _vSpareSemaphores.pop_back();
+        }
+    }
+
+    vk::DescriptorPool Renderer::createDescriptorPool(vk::Device& vDevice) const noexcept {
+        vk::DescriptorPoolSize poolSize{};
+        poolSize.type = vk::DescriptorType::eStorageBuffer;
+        poolSize.descriptorCount = constants::config::VULKAN_MAX_STORAGE_BUFFER_DESCRIPTORS;
+
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.flags = vk::DescriptorPoolCreateFlags();
+        poolInfo.maxSets = constants::config::VULKAN_MAX_DESCRIPTOR_SETS;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+
+        try {
+            return vDevice.createDescriptorPool(poolInfo);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_DESCRIPTOR_POOL_CREATION_FAILED, err.what()));
+#endif
+        }
+
+        return nullptr;
+    }
+
+    void Renderer::createFrameDescriptorSets(vk::Device& vDevice, vk::DescriptorPool& vDescriptorPool, vk::DescriptorSetLayout vDescriptorSetLayout, vk::DescriptorSetLayout vCullDescriptorSetLayout, std::vector<structures::VFrame>& vFrames) const noexcept {
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.descriptorPool = vDescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &vDescriptorSetLayout;
+
+        vk::DescriptorSetAllocateInfo cullAllocInfo{};
+        cullAllocInfo.descriptorPool = vDescriptorPool;
+        cullAllocInfo.descriptorSetCount = 1;
+        cullAllocInfo.pSetLayouts = &vCullDescriptorSetLayout;
+
+        for (auto& frame : vFrames) {
+            try {
+                frame.descriptorSet = vDevice.allocateDescriptorSets(allocInfo)[0];
+                if (vCullDescriptorSetLayout)
+                    frame.cullDescriptorSet = vDevice.allocateDescriptorSets(cullAllocInfo)[0];
+            } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_DESCRIPTOR_SET_ALLOCATION_FAILED, err.what()));
+#endif
+                return;
+            }
+        }
+    }
+
+    structures::VBuffer Renderer::createBuffer(vk::Device& vDevice, vk::DeviceSize size, vk::BufferUsageFlags vUsage, vk::MemoryPropertyFlags vProperties, const std::vector<uint32_t>& vQueueFamilyIndices) const noexcept {
+        structures::VBuffer vBuffer{};
+
+        vk::BufferCreateInfo bufferInfo{};
+        bufferInfo.flags = vk::BufferCreateFlags();
+        bufferInfo.size = size;
+        bufferInfo.usage = vUsage;
+        if (vQueueFamilyIndices.size() > 1) {
+            bufferInfo.sharingMode = vk::SharingMode::eConcurrent;
+            bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(vQueueFamilyIndices.size());
+            bufferInfo.pQueueFamilyIndices = vQueueFamilyIndices.data();
+        } else {
+            bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+        }
+
+        try {
+            vBuffer.buffer = vDevice.createBuffer(bufferInfo);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_BUFFER_CREATION_FAILED, err.what()));
+#endif
+            return {};
+        }
+
+        const vk::MemoryRequirements requirements = vDevice.getBufferMemoryRequirements(vBuffer.buffer);
+        vBuffer.allocation = _memoryAllocator->allocate(requirements, vProperties, AllocationTiling::linear);
+        if (!vBuffer.allocation.block) {
+            destroyBuffer(vDevice, vBuffer);
+            return {};
+        }
+
+        try {
+            vDevice.bindBufferMemory(vBuffer.buffer, vBuffer.allocation.memory, vBuffer.allocation.offset);
+            if (vProperties & vk::MemoryPropertyFlagBits::eHostVisible)
+                vBuffer.mapped = vBuffer.allocation.mapped;
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_MEMORY_ALLOCATION_FAILED, err.what()));
+#endif
+            destroyBuffer(vDevice, vBuffer);
+            return {};
+        }
+
+        vBuffer.size = size;
+        return vBuffer;
+    }
+
+    void Renderer::destroyBuffer(vk::Device& vDevice, structures::VBuffer& vBuffer) const noexcept {
+        // allocation blocks stay mapped, so there is nothing to unmap per buffer
+        vDevice.destroyBuffer(vBuffer.buffer);
+        _memoryAllocator->free(vBuffer.allocation);
+        vBuffer = {};
+    }
+
+    void Renderer::reserveFrameInstances(structures::VFrame& vFrame, std::size_t instanceCount) noexcept {
+        if (instanceCount <= vFrame.instanceCapacity && vFrame.instanceBuffer.buffer)
+            return;
+
+        destroyBuffer(_vDevice, vFrame.instanceBuffer);
+        destroyBuffer(_vDevice, vFrame.visibleBuffer);
+
+        vFrame.instanceCapacity = std::max(constants::config::VULKAN_MIN_INSTANCE_CAPACITY, std::bit_ceil(instanceCount));
+        vFrame.uploadedScene = nullptr;
+        const vk::DeviceSize instancesSize = vFrame.instanceCapacity * sizeof(shader::model::Triangle);
+
+        // written by the transfer queue and read by graphics, shared instead of passing ownership every frame
+        std::vector<uint32_t> queueFamilyIndices{ _vQueueFamilies.graphicsFamily.value() };
+        if (_vQueueFamilies.transferFamily.value() != _vQueueFamilies.graphicsFamily.value())
+            queueFamilyIndices.push_back(_vQueueFamilies.transferFamily.value());
+
+        vFrame.instanceBuffer = createBuffer(
+            _vDevice,
+            instancesSize,
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            queueFamilyIndices
+        );
+
+        // written by the cull shader, or directly by the CPU cull when there is no GPU culling
+        vFrame.visibleBuffer = createBuffer(
+            _vDevice,
+            vFrame.instanceCapacity * sizeof(uint32_t),
+            vk::BufferUsageFlagBits::eStorageBuffer,
+            _vGpuCulling
+                ? vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal)
+                : vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+        );
+
+        writeStorageDescriptor(vFrame.descriptorSet, 0, vFrame.instanceBuffer);
+        writeStorageDescriptor(vFrame.descriptorSet, 1, vFrame.visibleBuffer);
+        if (!_vGpuCulling)
+            return;
+
+        // host visible so the surviving instance count can be read back once the frame completes,
+        // the read invalidates when the memory type is not coherent
+        if (!vFrame.drawBuffer.buffer) {
+            vFrame.drawBuffer = createBuffer(
+                _vDevice,
+                sizeof(shader::model::DrawCommand),
+                vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                vk::MemoryPropertyFlagBits::eHostVisible
+            );
+        }
+
+        writeStorageDescriptor(vFrame.cullDescriptorSet, 0, vFrame.instanceBuffer);
+        writeStorageDescriptor(vFrame.cullDescriptorSet, 1, vFrame.visibleBuffer);
+        writeStorageDescriptor(vFrame.cullDescriptorSet, 2, vFrame.drawBuffer);
+    }
+
+    void Renderer::writeStorageDescriptor(vk::DescriptorSet vDescriptorSet, uint32_t binding, const structures::VBuffer& vBuffer) const noexcept {
+        vk::DescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = vBuffer.buffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = VK_WHOLE_SIZE;
+
+        vk::WriteDescriptorSet descriptorWrite{};
+        descriptorWrite.dstSet = vDescriptorSet;
+        descriptorWrite.dstBinding = binding;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = vk::DescriptorType::eStorageBuffer;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+
+        _vDevice.updateDescriptorSets(descriptorWrite, nullptr);
+    }
+
+    bool Renderer::stageFrameInstances(structures::VFrame& vFrame, std::size_t instanceCount) noexcept {
+        const vk::DeviceSize size = instanceCount * sizeof(shader::model::Triangle);
+
+        // every other frame in flight may still hold its range, plus up to one range lost to wrapping
+        const vk::DeviceSize requiredCapacity = size * (_vMaxFramesInFlight + 1);
+        if (!_stagingRing || requiredCapacity > _stagingRing->getCapacity()) {
+            _vDevice.waitIdle();
+            destroyBuffer(_vDevice, _vStagingBuffer);
+
+            const vk::DeviceSize capacity = std::max(constants::config::VULKAN_MIN_STAGING_CAPACITY, std::bit_ceil(requiredCapacity));
+            _vStagingBuffer = createBuffer(
+                _vDevice,
+                capacity,
+                vk::BufferUsageFlagBits::eTransferSrc,
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+            );
+            if (!_vStagingBuffer.mapped) {
+                _stagingRing.reset();
+                return false;
+            }
+
+            _stagingRing = std::make_unique<StagingRing>(capacity, _vMaxFramesInFlight);
+#if(TV_DEBUG_MODE)
+            Logger::instance().log(std::format("{}: {} bytes\n", constants::messages::VULKAN_STAGING_RING_RESIZED, capacity));
+#endif
+        }
+
+        // the slot's previous frame has completed, so its ranges are free again
+        _stagingRing->beginFrame(_vFrameNumber);
+        const std::optional<uint64_t> offset = _stagingRing->allocate(size, constants::config::VULKAN_STAGING_ALIGNMENT);
+        _stagingRing->endFrame(_vFrameNumber);
+        if (!offset) {
+            Logger::instance().err(std::format("{}: {} bytes\n", constants::messages::VULKAN_STAGING_ALLOCATION_FAILED, size));
+            return false;
+        }
+
+        vFrame.stagingOffset = offset.value();
+        return true;
+    }
+
+    void Renderer::recordTransferCommands(const structures::VFrame& vFrame, const std::vector<vk::BufferCopy>& vRegions) const noexcept {
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+
+        try {
+            vFrame.transferCommandBuffer.begin(beginInfo);
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+            return;
+        }
+
+        vFrame.transferCommandBuffer.copyBuffer(_vStagingBuffer.buffer, vFrame.instanceBuffer.buffer, vRegions);
+
+        try {
+            vFrame.transferCommandBuffer.end();
+        } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().err(std::format("{}\n", err.what()));
+#endif
+            return;
+        }
+    }
+
+    bool Renderer::submitUpload(structures::VFrame& vFrame, const SceneSnapshot* snapshot) noexcept {
+        // one copy per run of changed chunks, the instance buffer keeps everything else from earlier frames
+        std::vector<vk::BufferCopy> regions;
+        const std::size_t instanceCount = snapshot->getInstanceCount();
+        for (std::size_t chunk = 0; chunk < snapshot->getChunkCount(); ++chunk) {
+            if (!chunkNeedsUpload(vFrame, snapshot, chunk))
+                continue;
+
+            const vk::DeviceSize first = chunk * constants::config::SCENE_CHUNK_CAPACITY * sizeof(shader::model::Triangle);
+            const vk::DeviceSize last = std::min((chunk + 1) * constants::config::SCENE_CHUNK_CAPACITY, instanceCount) * sizeof(shader::model::Triangle);
+            if (!regions.empty() && regions.back().dstOffset + regions.back().size == first) {
+                regions.back().size += last - first;
+            } else {
+                vk::BufferCopy region{};
+                region.srcOffset = vFrame.stagingOffset + first;
+                region.dstOffset = first;
+                region.size = last - first;
+                regions.push_back(region);
+            }
+        }
+
+        // an empty submission still signals, so the graphics submit can always wait on the upload
+        vk::SubmitInfo submitInfo{};
+        if (!regions.empty()) {
+            recordTransferCommands(vFrame, regions);
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &vFrame.transferCommandBuffer;
+        }
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &vFrame.uploadFinished;
+
+        try {
+            _vTransferQueue.submit(submitInfo, nullptr);
+        } catch (const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().log(std::format("{}\n", err.what()));
+#endif
+            return false;
+        }
+
+        vFrame.uploadedScene = snapshot->getSource();
+        vFrame.uploadedSceneVersion = snapshot->getVersion();
+        return true;
+    }
+
+    void Renderer::readVisibleInstanceCount(const structures::VFrame& vFrame) noexcept {
+        // only called once the frame's timeline value is reached
+        if (!_vGpuCulling || !vFrame.drawBuffer.mapped)
+            return;
+
+        _memoryAllocator->invalidate(vFrame.drawBuffer.allocation);
+        _visibleInstanceCount = static_cast<const shader::model::DrawCommand*>(vFrame.drawBuffer.mapped)->instanceCount;
+    }
+
+    void Renderer::cullFrameInstances(structures::VFrame& vFrame, const SceneSnapshot* snapshot) noexcept {
+        if (_vGpuCulling)
+            return;
+
+        _visibleInstances.clear();
+        snapshot->cull(Frustum{ snapshot->getViewProjection() }, _visibleInstances);
+        if (vFrame.visibleBuffer.mapped)
+            std::memcpy(vFrame.visibleBuffer.mapped, _visibleInstances.data(), _visibleInstances.size() * sizeof(uint32_t));
+
+        vFrame.visibleCount = static_cast<uint32_t>(_visibleInstances.size());
+        _visibleInstanceCount = vFrame.visibleCount;
+    }
+
+    bool Renderer::chunkNeedsUpload(const structures::VFrame& vFrame, const SceneSnapshot* snapshot, std::size_t chunkIndex) const noexcept {
+        return vFrame.uploadedScene != snapshot->getSource() || snapshot->chunkChangedSince(chunkIndex, vFrame.uploadedSceneVersion);
+    }
+
+    void Renderer::uploadInstances(structures::VFrame& vFrame, const SceneSnapshot* snapshot, std::size_t firstInstance, std::size_t lastInstance) const noexcept {
+        assert(_vStagingBuffer.mapped);
+        static_assert(sizeof(shader::model::Triangle) == sizeof(glm::mat4));
+        auto* staging = static_cast<std::byte*>(_vStagingBuffer.mapped) + vFrame.stagingOffset;
+        auto* models = reinterpret_cast<glm::mat4*>(staging);
+
+        // only chunks the frame's instance buffer is missing are copied, clipped to this worker's range
+        constexpr std::size_t chunkSize = constants::config::SCENE_CHUNK_CAPACITY;
+        for (std::size_t chunk = firstInstance / chunkSize; chunk * chunkSize < lastInstance; ++chunk) {
+            if (!chunkNeedsUpload(vFrame, snapshot, chunk))
+                continue;
+
+            const std::size_t first = std::max(firstInstance, chunk * chunkSize);
+            const std::size_t last = std::min(lastInstance, (chunk + 1) * chunkSize);
+            snapshot->copyWorldMatrices(first, last, models + first);
         }
     }
 
@@ -845,15 +2388,18 @@ namespace tv {
     }
 
     vk::Instance Renderer::createInstance() const noexcept {
-        assert(glfwVulkanSupported());
         auto& logger = Logger::instance();
 
-        uint32_t vulkanVersion{ 0 };
-        vkEnumerateInstanceVersion(&vulkanVersion);
+        // the instance asks for everything the loader offers, devices are capped by it
+        const uint32_t vulkanVersion = _vInstanceApiVersion;
 
         uint32_t vulkanExtensionCount = 0;
-        auto rawGlfwExtensions = glfwGetRequiredInstanceExtensions(&vulkanExtensionCount);
-        std::vector<const char*> vulkanExtensions{ rawGlfwExtensions, rawGlfwExtensions + vulkanExtensionCount };
+        std::vector<const char*> vulkanExtensions;
+        if (!headless()) {
+            assert(glfwVulkanSupported());
+            auto rawGlfwExtensions = glfwGetRequiredInstanceExtensions(&vulkanExtensionCount);
+            vulkanExtensions.assign(rawGlfwExtensions, rawGlfwExtensions + vulkanExtensionCount);
+        }
         std::vector<const char*> vulkanLayers{};
 
 #if(TV_DEBUG_MODE)
@@ -959,8 +2505,10 @@ namespace tv {
 
         assert(familyIndices.graphicsFamily.has_value() && familyIndices.presentFamily.has_value());
         uniqueFamilyIndices.emplace_back(familyIndices.graphicsFamily.value());
-        if (familyIndices.graphicsFamily.value() != familyIndices.presentFamily.value())
-            uniqueFamilyIndices.emplace_back(familyIndices.presentFamily.value());
+        for (const uint32_t index : { familyIndices.presentFamily.value(), familyIndices.transferFamily.value() }) {
+            if (std::ranges::find(uniqueFamilyIndices, index) == uniqueFamilyIndices.end())
+                uniqueFamilyIndices.emplace_back(index);
+        }
 
         float queuePriority{ 1 };
         constexpr uint32_t queueCount{ 1 };
@@ -975,11 +2523,19 @@ namespace tv {
             });
         }
 
-        std::vector<const char*> deviceExtensions{
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME
-        };
+        std::vector<const char*> deviceExtensions;
+        if (vSurface)
+            deviceExtensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
         vk::PhysicalDeviceFeatures deviceFeatures{};
+        vk::PhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.drawIndirectCount = gpuCullingSupported(vPhysicalDevice) ? VK_TRUE : VK_FALSE;
+        vulkan12Features.timelineSemaphore = VK_TRUE;
+        vk::PhysicalDeviceVulkan13Features vulkan13Features{};
+        vulkan13Features.dynamicRendering = VK_TRUE;
+        if (dynamicRenderingSupported(vPhysicalDevice))
+            vulkan12Features.pNext = &vulkan13Features;
+
         std::vector<const char*> enabledLayers;
 #if(TV_DEBUG_MODE)
         enabledLayers.emplace_back(constants::config::VULKAN_LAYER_VALIDATION);
@@ -994,6 +2550,8 @@ namespace tv {
             deviceExtensions.data(),
             &deviceFeatures
         };
+        if (apiVersion(vPhysicalDevice) >= VK_API_VERSION_1_2)
+            deviceInfo.pNext = &vulkan12Features;
 
         try {
             return vPhysicalDevice.createDevice(deviceInfo);
@@ -1011,10 +2569,11 @@ namespace tv {
         structures::VQueueFamilyIndices indices = findQueueFamilies(vPhysicalDevice, vSurface);
         constexpr uint32_t queueIndex{ 0 };
 
-        assert(indices.graphicsFamily.has_value() && indices.presentFamily.has_value());
+        assert(indices.graphicsFamily.has_value() && indices.presentFamily.has_value() && indices.transferFamily.has_value());
         return {
             vDevice.getQueue(indices.graphicsFamily.value(), queueIndex),
-            vDevice.getQueue(indices.presentFamily.value(), queueIndex)
+            vDevice.getQueue(indices.presentFamily.value(), queueIndex),
+            vDevice.getQueue(indices.transferFamily.value(), queueIndex)
         };
     }
 }
@@ -5,9 +5,22 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <memory>
+#include <optional>
+#include <chrono>
+#include <initializer_list>
+#include <string>
+
+#include "frame_timings.hpp"
+#include "layout_cache.hpp"
+#include "memory_allocator.hpp"
+#include "pipeline_manager.hpp"
+#include "render_structures.hpp"
+#include "shader_library.hpp"
+#include "staging_ring.hpp"
 #include "../utility/types.hpp"
 #include "../utility/structures.hpp"
-#include "../scene/scene.hpp"
+#include "../scene/scene_snapshot.hpp"
 
 namespace tv {
     class Renderer {
@@ -16,14 +29,24 @@ namespace tv {
 
         static Renderer& instance() noexcept;
         static void setup(Renderer& renderer, GLFWwindow* window) noexcept;
-        void render(Scene* scene) noexcept;
+        static void setupHeadless(Renderer& renderer, vk::Extent2D extent) noexcept;
+        void render(const SceneSnapshot* snapshot) noexcept;
+        [[nodiscard]] structures::VHostFrame getLastFrame() noexcept;
+        [[nodiscard]] uint64_t getSubmittedFrame() const noexcept;
+        [[nodiscard]] uint64_t getCompletedFrame() const noexcept;
+        [[nodiscard]] bool waitForFrame(uint64_t frameValue) const noexcept;
+        [[nodiscard]] uint32_t getVisibleInstanceCount() const noexcept;
+        [[nodiscard]] const FrameTimings& getFrameTimings() const noexcept;
+        void benchmarkRecording(const SceneSnapshot* snapshot) noexcept;
 
     private:
         Renderer() noexcept;
 
         ~Renderer();
 
-        void init(GLFWwindow* window) noexcept;
+        void init(GLFWwindow* window, vk::Extent2D extent) noexcept;
+        void renderOffscreen(const SceneSnapshot* snapshot) noexcept;
+        [[nodiscard]] bool headless() const noexcept;
 
         [[nodiscard]] vk::Instance createInstance() const noexcept;
         void createSurface(GLFWwindow* window, vk::Instance& vInstance, vk::SurfaceKHR& vSurface) const noexcept;
@@ -31,14 +54,33 @@ namespace tv {
         [[nodiscard]] vk::PhysicalDevice chooseDevice(const vk::Instance& vInstance) const noexcept;
         [[nodiscard]] vk::Device createLogicalDevice(vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept;
         [[nodiscard]] std::vector<vk::Queue> getQueues(const vk::PhysicalDevice& vPhysicalDevice, vk::Device& vDevice, vk::SurfaceKHR& vSurface) const noexcept;
-        [[nodiscard]] structures::VSwapChainBundle createSwapchain(GLFWwindow* window, vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface, std::size_t& vMaxFramesInFlight) const noexcept;
+        [[nodiscard]] structures::VSwapChainBundle createSwapchain(GLFWwindow* window, vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface, vk::SwapchainKHR vOldSwapchain) const noexcept;
+        [[nodiscard]] structures::VSwapChainBundle createOffscreenTargets(vk::Device& vDevice, vk::Extent2D extent, std::size_t imageCount) const noexcept;
         void resetSwapchain() noexcept;
+        void releaseSwapchainImages(std::vector<structures::VSwapChainImage>& vImages) noexcept;
+        void destroyRetiredSwapchains(uint64_t completedFrame) noexcept;
+        void destroyFrames() noexcept;
+        [[nodiscard]] vk::PipelineCache createPipelineCache(vk::Device& vDevice, const vk::PhysicalDevice& vPhysicalDevice) const noexcept;
+        void savePipelineCache(vk::Device& vDevice, const vk::PhysicalDevice& vPhysicalDevice, vk::PipelineCache vPipelineCache) const noexcept;
+        [[nodiscard]] structures::VPipelineCacheHeader makePipelineCacheHeader(const vk::PhysicalDevice& vPhysicalDevice, uint64_t dataSize) const noexcept;
         [[nodiscard]] structures::VGraphicsPipelineBundle createPipeline(vk::Device& vDevice, structures::VSwapChainBundle& vSwapchainBundle) const noexcept;
-        void finalSetup(vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR vSurface, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, vk::CommandPool& vCommandPool, vk::CommandBuffer vMainCommandBuffer) const noexcept;
+        [[nodiscard]] structures::VGraphicsPipelineInBundle makeGraphicsPipelineInBundle(vk::Device& vDevice, vk::Format vSwapchainImageFormat) const noexcept;
+        [[nodiscard]] structures::VComputePipelineInBundle makeCullPipelineInBundle(vk::Device& vDevice) const noexcept;
+        void reloadShaders() noexcept;
+        void updatePipelines() noexcept;
+        void finalSetup(vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR vSurface, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, std::vector<structures::VFrame>& vFrames, vk::CommandPool& vCommandPool, vk::CommandBuffer vMainCommandBuffer) noexcept;
         void recreateSwapchain() noexcept;
 
         void printAdditionalInfo(const uint32_t vulkanVersion, const std::vector<const char*>& glfwExtensions) const noexcept;
         [[nodiscard]] bool deviceIsSuitable(const vk::PhysicalDevice& vDevice) const noexcept;
+        [[nodiscard]] uint32_t instanceApiVersion() const noexcept;
+        // the version usable with the device, capped by the instance's: core features beyond it are off limits
+        [[nodiscard]] uint32_t apiVersion(const vk::PhysicalDevice& vPhysicalDevice) const noexcept;
+        [[nodiscard]] bool timelineSemaphoresSupported(const vk::PhysicalDevice& vPhysicalDevice) const noexcept;
+        [[nodiscard]] bool dynamicRenderingSupported(const vk::PhysicalDevice& vPhysicalDevice) const noexcept;
+        [[nodiscard]] bool gpuCullingSupported(const vk::PhysicalDevice& vPhysicalDevice) const noexcept;
+        [[nodiscard]] float timestampPeriod(const vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept;
+        [[nodiscard]] uint64_t timestampMask(const vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept;
         [[nodiscard]] structures::VQueueFamilyIndices findQueueFamilies(const vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept;
         [[nodiscard]] bool extensionsSupported(const std::vector<const char*>& vulkanExtensions) const noexcept;
         [[nodiscard]] bool layersSupported(const std::vector<const char*>& vulkanLayers) const noexcept;
@@ -46,33 +88,92 @@ namespace tv {
         [[nodiscard]] vk::SurfaceFormatKHR chooseSwapchainSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& vFormats) const noexcept;
         [[nodiscard]] vk::PresentModeKHR chooseSwapchainPresentMode(const std::vector<vk::PresentModeKHR>& vPresentMods) const noexcept;
         [[nodiscard]] vk::Extent2D chooseSwapchainExtent(GLFWwindow* window, const vk::SurfaceCapabilitiesKHR& vCapabilities) const noexcept;
-        [[nodiscard]] vk::ShaderModule createShaderModule(const std::string& filePath, vk::Device& vDevice) const noexcept;
-        [[nodiscard]] vk::PipelineLayout createPipelineLayout(vk::Device& vDevice) const noexcept;
-        [[nodiscard]] vk::RenderPass createRenderpass(vk::Device& vDevice, vk::Format vSwapchainImageFormat) const noexcept;
+        [[nodiscard]] ReflectedLayout createReflectedLayout(std::initializer_list<std::string> filePaths) const noexcept;
+        [[nodiscard]] vk::RenderPass createRenderpass(vk::Device& vDevice, vk::Format vSwapchainImageFormat, vk::ImageLayout vFinalLayout) const noexcept;
         [[nodiscard]] structures::VGraphicsPipelineBundle createGraphicsPipeline(structures::VGraphicsPipelineInBundle& vPipelineInBundle) const noexcept;
+        [[nodiscard]] vk::Pipeline compileGraphicsPipeline(const structures::VGraphicsPipelineInBundle& vPipelineInBundle, vk::PipelineLayout vPipelineLayout, vk::RenderPass vRenderpass) const noexcept;
+        [[nodiscard]] structures::VComputePipelineBundle createCullPipeline(vk::Device& vDevice) const noexcept;
+        [[nodiscard]] structures::VComputePipelineBundle createComputePipeline(structures::VComputePipelineInBundle& vPipelineInBundle) const noexcept;
+        [[nodiscard]] vk::Pipeline compileComputePipeline(const structures::VComputePipelineInBundle& vPipelineInBundle, vk::PipelineLayout vPipelineLayout) const noexcept;
         void createFramebuffers(vk::Device& vDevice, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle) const noexcept;
-        [[nodiscard]] vk::CommandPool createCommandPool(vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface) const noexcept;
+        [[nodiscard]] vk::CommandPool createCommandPool(vk::Device& vDevice, uint32_t queueFamilyIndex, vk::CommandPoolCreateFlags vFlags) const noexcept;
         void createFrameCommandBuffers(structures::VCommandBufferInput& vInputChunk) const noexcept;
+        void createFrameTransferCommandBuffers(structures::VCommandBufferInput& vInputChunk) const noexcept;
+        void createFrameWorkerCommandBuffers(vk::Device& vDevice, vk::PhysicalDevice& vPhysicalDevice, vk::SurfaceKHR& vSurface, std::vector<structures::VFrame>& vFrames, std::size_t workerCount) const noexcept;
         [[nodiscard]] vk::CommandBuffer createCommandBuffer(structures::VCommandBufferInput& vInputChunk) const noexcept;
         [[nodiscard]] vk::Semaphore createSemaphore(vk::Device& vDevice) const noexcept;
-        [[nodiscard]] vk::Fence createFence(vk::Device& vDevice) const noexcept;
-        void recordDrawCommands(vk::CommandBuffer& vCommandBuffer, uint32_t imageIndex, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, Scene* scene) const noexcept;
-        void createFrameSyncObjects(vk::Device& vDevice, structures::VSwapChainBundle& vSwapChainBundle) const noexcept;
+        [[nodiscard]] vk::Semaphore createTimelineSemaphore(vk::Device& vDevice) const noexcept;
+        [[nodiscard]] bool waitForFrameSlot(const structures::VFrame& vFrame) const noexcept;
+        void abandonFrame(structures::VFrame& vFrame, const std::vector<vk::Semaphore>& vSignalledSemaphores) noexcept;
+        [[nodiscard]] vk::QueryPool createTimestampQueryPool(vk::Device& vDevice) const noexcept;
+        [[nodiscard]] double readGpuTime(structures::VFrame& vFrame) const noexcept;
+        void pushFrameTiming(FrameTiming& timing, std::chrono::steady_clock::time_point frameStart) noexcept;
+        void recordFrame(structures::VFrame& vFrame, uint32_t imageIndex, const SceneSnapshot* snapshot, std::size_t maxChunkCount) noexcept;
+        void recordDrawCommands(vk::CommandBuffer& vCommandBuffer, uint32_t imageIndex, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VComputePipelineBundle& vCullPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, const structures::VFrame& vFrame, const SceneSnapshot* snapshot, std::size_t chunkCount) const noexcept;
+        void recordChunkCommands(std::size_t chunkIndex, std::size_t chunkCount, uint32_t imageIndex, structures::VGraphicsPipelineBundle& vGraphicsPipelineBundle, structures::VSwapChainBundle& vSwapChainBundle, structures::VFrame& vFrame, const SceneSnapshot* snapshot) const noexcept;
+        void recordImageBarrier(vk::CommandBuffer& vCommandBuffer, vk::Image vImage, vk::ImageLayout vOldLayout, vk::ImageLayout vNewLayout, vk::PipelineStageFlags vSrcStage, vk::AccessFlags vSrcAccess, vk::PipelineStageFlags vDstStage, vk::AccessFlags vDstAccess) const noexcept;
+        void recordReadbackCommands(vk::CommandBuffer& vCommandBuffer, const structures::VSwapChainImage& vImage, vk::Extent2D extent) const noexcept;
+        void recordTransferCommands(const structures::VFrame& vFrame, const std::vector<vk::BufferCopy>& vRegions) const noexcept;
+        [[nodiscard]] bool submitUpload(structures::VFrame& vFrame, const SceneSnapshot* snapshot) noexcept;
+        void readVisibleInstanceCount(const structures::VFrame& vFrame) noexcept;
+        void cullFrameInstances(structures::VFrame& vFrame, const SceneSnapshot* snapshot) noexcept;
+        [[nodiscard]] bool chunkNeedsUpload(const structures::VFrame& vFrame, const SceneSnapshot* snapshot, std::size_t chunkIndex) const noexcept;
+        void recordCullCommands(vk::CommandBuffer& vCommandBuffer, structures::VComputePipelineBundle& vCullPipelineBundle, const structures::VFrame& vFrame, const SceneSnapshot* snapshot) const noexcept;
+        void createFrameSyncObjects(vk::Device& vDevice, std::vector<structures::VFrame>& vFrames) const noexcept;
+        void createImageSyncObjects(vk::Device& vDevice, structures::VSwapChainBundle& vSwapChainBundle) noexcept;
+        [[nodiscard]] vk::DescriptorPool createDescriptorPool(vk::Device& vDevice) const noexcept;
+        void createFrameDescriptorSets(vk::Device& vDevice, vk::DescriptorPool& vDescriptorPool, vk::DescriptorSetLayout vDescriptorSetLayout, vk::DescriptorSetLayout vCullDescriptorSetLayout, std::vector<structures::VFrame>& vFrames) const noexcept;
+        [[nodiscard]] structures::VBuffer createBuffer(vk::Device& vDevice, vk::DeviceSize size, vk::BufferUsageFlags vUsage, vk::MemoryPropertyFlags vProperties, const std::vector<uint32_t>& vQueueFamilyIndices = {}) const noexcept;
+        void destroyBuffer(vk::Device& vDevice, structures::VBuffer& vBuffer) const noexcept;
+        void reserveFrameInstances(structures::VFrame& vFrame, std::size_t instanceCount) noexcept;
+        [[nodiscard]] bool stageFrameInstances(structures::VFrame& vFrame, std::size_t instanceCount) noexcept;
+        void writeStorageDescriptor(vk::DescriptorSet vDescriptorSet, uint32_t binding, const structures::VBuffer& vBuffer) const noexcept;
+        void uploadInstances(structures::VFrame& vFrame, const SceneSnapshot* snapshot, std::size_t firstInstance, std::size_t lastInstance) const noexcept;
 
         GLFWwindow* _window;
         vk::Instance _vInstance;
+        uint32_t _vInstanceApiVersion;
         vk::PhysicalDevice _vPhysicalDevice;
+        uint32_t _vApiVersion;
         vk::Device _vDevice;
         vk::Queue _vGraphicsQueue;
         vk::Queue _vPresentQueue;
+        vk::Queue _vTransferQueue;
+        structures::VQueueFamilyIndices _vQueueFamilies;
         structures::VSwapChainBundle _vSwapChainBundle;
+        std::vector<structures::VFrame> _vFrames;
+        std::vector<structures::VRetiredSwapchain> _vRetiredSwapchains;
+        std::vector<vk::Semaphore> _vSpareSemaphores;
+        bool _vSwapchainOutdated;
         vk::DebugUtilsMessengerEXT _vDebugMessenger;
         vk::DispatchLoaderDynamic _vDispatchLoaderDynamic;
         vk::SurfaceKHR _vSurface;
+        vk::PipelineCache _vPipelineCache;
+        // signalled with the frame number by each graphics submission
+        vk::Semaphore _vFrameTimeline;
+        uint64_t _vSubmittedFrame;
         structures::VGraphicsPipelineBundle _vGraphicsPipelineBundle;
+        structures::VComputePipelineBundle _vCullPipelineBundle;
+        std::unique_ptr<ShaderLibrary> _shaderLibrary;
+        std::unique_ptr<LayoutCache> _layoutCache;
+        std::unique_ptr<PipelineManager> _pipelineManager;
+        vk::DescriptorPool _vDescriptorPool;
         vk::CommandPool _vCommandPool;
         vk::CommandBuffer _vMainCommandBuffer;
+        vk::CommandPool _vTransferCommandPool;
+        structures::VBuffer _vStagingBuffer;
+        std::unique_ptr<StagingRing> _stagingRing;
+        std::unique_ptr<MemoryAllocator> _memoryAllocator;
         std::size_t _vMaxFramesInFlight;
         std::size_t _vFrameNumber;
+        std::optional<std::size_t> _vLastFrameNumber;
+        bool _vGpuCulling;
+        bool _vDynamicRendering;
+        float _vTimestampPeriod;
+        uint64_t _vTimestampMask;
+        FrameTimings _frameTimings;
+        std::chrono::steady_clock::time_point _lastFrameStart;
+        uint32_t _visibleInstanceCount;
+        std::vector<uint32_t> _visibleInstances;
     };
 }
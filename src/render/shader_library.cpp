@@ -0,0 +1,262 @@
+#include "shader_library.hpp"
+
+#include <algorithm>
+#include <format>
+
+#if defined(__linux__) && __has_include(<sys/inotify.h>)
+    #define TV_SHADER_WATCH 1
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#else
+    #define TV_SHADER_WATCH 0
+#endif
+
+#include "../logger.hpp"
+#include "../services/file_service.hpp"
+#include "../shaders/embedded_shaders.hpp"
+#include "../utility/config.hpp"
+#include "../utility/messages.hpp"
+
+namespace tv {
+    ShaderLibrary::ShaderLibrary(vk::Device vDevice) noexcept
+        : _vDevice{ vDevice },
+          _watch{ -1 },
+          _lastPoll{}
+    {}
+
+    ShaderLibrary::~ShaderLibrary() {
+        for (const auto& module : _modules)
+            _vDevice.destroyShaderModule(module.second.module);
+
+#if(TV_SHADER_WATCH)
+        if (_watch >= 0)
+            close(_watch);
+#endif
+    }
+
+    vk::ShaderModule ShaderLibrary::get(const std::string& filePath) noexcept {
+        std::scoped_lock lock{ _mutex };
+
+        const Module* module = find(filePath);
+        return module ? module->module : nullptr;
+    }
+
+    std::optional<shader::Reflection> ShaderLibrary::getReflection(const std::string& filePath) noexcept {
+        std::scoped_lock lock{ _mutex };
+
+        const Module* module = find(filePath);
+        if (!module)
+            return std::nullopt;
+
+        return module->reflection;
+    }
+
+    void ShaderLibrary::watch(const std::filesystem::path& directory) noexcept {
+        if (isWatching())
+            return;
+
+#if(TV_SHADER_WATCH)
+        _watch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        // compilers either write the file in place or rename a finished temporary over it
+        if (_watch >= 0 && inotify_add_watch(_watch, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0) {
+#if(TV_DEBUG_MODE)
+            Logger::instance().log(std::format("{}: {}\n", constants::messages::SHADER_WATCH_STARTED, directory.string()));
+#endif
+            return;
+        }
+
+        if (_watch >= 0)
+            close(_watch);
+        _watch = -1;
+#endif
+
+        std::error_code error;
+        if (!std::filesystem::is_directory(directory, error)) {
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::SHADER_WATCH_FAILED, directory.string()));
+            return;
+        }
+
+        // files already there are the baseline, only later writes count as changes
+        _polledDirectory = directory;
+        _lastPoll = std::chrono::steady_clock::now();
+        pollWriteTimes(nullptr);
+#if(TV_DEBUG_MODE)
+        Logger::instance().log(std::format("{}: {}\n", constants::messages::SHADER_WATCH_POLLING, directory.string()));
+#endif
+    }
+
+    std::vector<std::string> ShaderLibrary::reload() noexcept {
+        const std::vector<std::string> names = readChangedNames();
+        if (names.empty())
+            return {};
+
+        std::scoped_lock lock{ _mutex };
+
+        std::vector<std::string> changed;
+        for (auto& [filePath, contentHash] : _files) {
+            if (std::ranges::find(names, std::filesystem::path{ filePath }.filename().string()) == names.end())
+                continue;
+
+            // from disk even for embedded shaders, an edited file overrides the built-in code;
+            // unreadable for now, the file keeps its module until a complete write comes in
+            const uint64_t newHash = load(filePath);
+            if (newHash == 0)
+                continue;
+
+            // rewritten with the same contents, e.g. by a full rebuild, is not a change
+            release(contentHash);
+            if (newHash == contentHash)
+                continue;
+
+            contentHash = newHash;
+            changed.push_back(filePath);
+#if(TV_DEBUG_MODE)
+            Logger::instance().log(std::format("{}: {}\n", constants::messages::SHADER_RELOADED, filePath));
+#endif
+        }
+
+        return changed;
+    }
+
+    bool ShaderLibrary::isWatching() const noexcept {
+        return _watch >= 0 || !_polledDirectory.empty();
+    }
+
+    uint64_t ShaderLibrary::hash(std::span<const char> data) noexcept {
+        // FNV-1a, binaries are a few kilobytes and hashed once per load
+        uint64_t result = 0xcbf29ce484222325ull;
+        for (const char byte : data) {
+            result ^= static_cast<unsigned char>(byte);
+            result *= 0x100000001b3ull;
+        }
+
+        return result;
+    }
+
+    const ShaderLibrary::Module* ShaderLibrary::find(const std::string& filePath) noexcept {
+        auto file = _files.find(filePath);
+        if (file == _files.end()) {
+            // compiled into the executable by the build, startup reads no shader files
+            const std::span<const uint32_t> embedded = shader::findEmbeddedShader(std::filesystem::path{ filePath }.filename().string());
+            const uint64_t contentHash = embedded.empty()
+                ? load(filePath)
+                : add({ reinterpret_cast<const char*>(embedded.data()), embedded.size_bytes() });
+            if (contentHash == 0)
+                return nullptr;
+
+            file = _files.emplace(filePath, contentHash).first;
+        }
+
+        return &_modules.at(file->second);
+    }
+
+    uint64_t ShaderLibrary::load(const std::string& filePath) noexcept {
+        const service::MappedFile file = service::FileService::map(filePath);
+        // SPIR-V is a sequence of words, anything else is a file caught mid-write
+        if (file.empty() || file.size() % sizeof(uint32_t) != 0)
+            return 0;
+
+        return add(file.getSpan());
+    }
+
+    uint64_t ShaderLibrary::add(std::span<const char> code) noexcept {
+        const uint64_t contentHash = hash(code);
+        auto [module, inserted] = _modules.try_emplace(contentHash, Module{ nullptr, {}, 0 });
+        if (inserted) {
+            // parsed once per distinct binary, pipeline layouts and vertex input are derived from it
+            std::optional<shader::Reflection> reflection = shader::reflect({ reinterpret_cast<const uint32_t*>(code.data()), code.size() / sizeof(uint32_t) });
+            if (!reflection) {
+                Logger::instance().err(std::format("{}\n", constants::messages::SHADER_REFLECTION_FAILED));
+                _modules.erase(module);
+                return 0;
+            }
+            module->second.reflection = std::move(reflection.value());
+
+            // straight from the mapped pages or the executable, the driver copies what it keeps
+            vk::ShaderModuleCreateInfo moduleInfo{};
+            moduleInfo.flags = vk::ShaderModuleCreateFlags();
+            moduleInfo.codeSize = code.size();
+            moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+            try {
+                module->second.module = _vDevice.createShaderModule(moduleInfo);
+            } catch ([[maybe_unused]] const vk::SystemError& err) {
+#if(TV_DEBUG_MODE)
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::VULKAN_SHADER_MODULE_CREATION_FAILED, err.what()));
+#endif
+                _modules.erase(module);
+                return 0;
+            }
+        }
+
+        ++module->second.fileCount;
+        return contentHash;
+    }
+
+    void ShaderLibrary::release(uint64_t contentHash) noexcept {
+        auto module = _modules.find(contentHash);
+        if (module == _modules.end() || --module->second.fileCount > 0)
+            return;
+
+        // modules are only read while pipelines are created, built pipelines do not depend on them
+        _vDevice.destroyShaderModule(module->second.module);
+        _modules.erase(module);
+    }
+
+    std::vector<std::string> ShaderLibrary::readChangedNames() noexcept {
+        std::vector<std::string> names;
+#if(TV_SHADER_WATCH)
+        if (_watch >= 0) {
+            alignas(inotify_event) char buffer[4096];
+        // non-blocking, drained until the kernel has nothing more queued
+            for (;;) {
+                const ssize_t length = ::read(_watch, buffer, sizeof(buffer));
+                if (length <= 0)
+                    break;
+
+                for (ssize_t offset = 0; offset < length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    if (event->len > 0)
+                        names.emplace_back(event->name);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+
+            return names;
+        }
+#endif
+        if (_polledDirectory.empty())
+            return names;
+
+        // reload runs every frame, the directory is only listed every interval
+        const auto now = std::chrono::steady_clock::now();
+        if (now - _lastPoll < std::chrono::milliseconds(constants::config::SHADER_POLL_INTERVAL_MS))
+            return names;
+
+        _lastPoll = now;
+        pollWriteTimes(&names);
+        return names;
+    }
+
+    void ShaderLibrary::pollWriteTimes(std::vector<std::string>* changedNames) noexcept {
+        std::error_code error;
+        for (std::filesystem::directory_iterator entry{ _polledDirectory, error }; !error && entry != std::filesystem::directory_iterator{}; entry.increment(error)) {
+            if (entry->path().extension() != ".spv")
+                continue;
+
+            // a file removed or replaced while listing is picked up by the next poll
+            std::error_code entryError;
+            const std::filesystem::file_time_type writeTime = entry->last_write_time(entryError);
+            if (entryError)
+                continue;
+
+            auto [known, inserted] = _writeTimes.try_emplace(entry->path().filename().string(), writeTime);
+            if (!inserted && known->second == writeTime)
+                continue;
+
+            known->second = writeTime;
+            if (changedNames)
+                changedNames->push_back(known->first);
+        }
+    }
+}
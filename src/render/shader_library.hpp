@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../shaders/reflection.hpp"
+#include "../utility/types.hpp"
+
+namespace tv {
+    // shader modules keyed by the hash of their SPIR-V: a file is read and its module created once
+    // however many pipelines use it, and identical binaries share one module. Shaders the build embedded
+    // are taken from the executable instead of their files. A watched directory reports rewritten files,
+    // which reload picks up: through inotify where available, by polling the files' write times elsewhere
+    class ShaderLibrary {
+    public:
+        TV_NCM(ShaderLibrary)
+
+        explicit ShaderLibrary(vk::Device vDevice) noexcept;
+
+        ~ShaderLibrary();
+
+        // loaded on first use, null if the file cannot be; the library owns the module
+        // and keeps it alive until a reload replaces the file's contents
+        [[nodiscard]] vk::ShaderModule get(const std::string& filePath) noexcept;
+        // the interface of the module get returns, read from its SPIR-V when the module was created
+        [[nodiscard]] std::optional<shader::Reflection> getReflection(const std::string& filePath) noexcept;
+        void watch(const std::filesystem::path& directory) noexcept;
+        // rereads the known files written since the last call, returns those whose contents changed
+        [[nodiscard]] std::vector<std::string> reload() noexcept;
+        [[nodiscard]] bool isWatching() const noexcept;
+
+        [[nodiscard]] static uint64_t hash(std::span<const char> data) noexcept;
+
+    private:
+        struct Module {
+            vk::ShaderModule module;
+            shader::Reflection reflection;
+            // files currently holding these contents
+            std::size_t fileCount;
+        };
+
+        // the file's module, loaded if it is not yet; null if it cannot be
+        [[nodiscard]] const Module* find(const std::string& filePath) noexcept;
+        // the hash of the file's current contents with their module created, zero if unreadable
+        [[nodiscard]] uint64_t load(const std::string& filePath) noexcept;
+        // zero if the code cannot be reflected or its module created
+        [[nodiscard]] uint64_t add(std::span<const char> code) noexcept;
+        void release(uint64_t contentHash) noexcept;
+        [[nodiscard]] std::vector<std::string> readChangedNames() noexcept;
+        // records the write times of the watched directory's SPIR-V files, adding the names of new or rewritten ones
+        void pollWriteTimes(std::vector<std::string>* changedNames) noexcept;
+
+        vk::Device _vDevice;
+        // pipelines are compiled on job system workers, which all come through get
+        std::mutex _mutex;
+        std::unordered_map<std::string, uint64_t> _files;
+        std::unordered_map<uint64_t, Module> _modules;
+        // inotify descriptor, negative when not watching through it
+        int _watch;
+        // the polled directory, empty when not polling
+        std::filesystem::path _polledDirectory;
+        std::unordered_map<std::string, std::filesystem::file_time_type> _writeTimes;
+        std::chrono::steady_clock::time_point _lastPoll;
+    };
+}
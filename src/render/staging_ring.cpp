@@ -0,0 +1,44 @@
+#include "staging_ring.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tv {
+    StagingRing::StagingRing(uint64_t capacity, std::size_t frameCount) noexcept
+        : _capacity{ capacity },
+          _head{ 0 },
+          _tail{ 0 },
+          _frameEnds(frameCount, 0)
+    {}
+
+    void StagingRing::beginFrame(std::size_t frameIndex) noexcept {
+        assert(frameIndex < _frameEnds.size());
+        _tail = std::max(_tail, _frameEnds[frameIndex]);
+    }
+
+    void StagingRing::endFrame(std::size_t frameIndex) noexcept {
+        assert(frameIndex < _frameEnds.size());
+        _frameEnds[frameIndex] = _head;
+    }
+
+    std::optional<uint64_t> StagingRing::allocate(uint64_t size, uint64_t alignment) noexcept {
+        assert(alignment != 0 && _capacity % alignment == 0);
+        if (size > _capacity)
+            return std::nullopt;
+
+        uint64_t position = (_head + alignment - 1) / alignment * alignment;
+        // a range never straddles the end of the buffer, skip to the next lap instead
+        if (position % _capacity + size > _capacity)
+            position += _capacity - position % _capacity;
+
+        if (position + size - _tail > _capacity)
+            return std::nullopt;
+
+        _head = position + size;
+        return position % _capacity;
+    }
+
+    uint64_t StagingRing::getCapacity() const noexcept {
+        return _capacity;
+    }
+}
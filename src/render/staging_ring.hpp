@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "../utility/types.hpp"
+
+namespace tv {
+    // hands out per-frame ranges of a host-visible staging buffer; a frame's ranges
+    // are recycled once that frame slot comes around again, i.e. after its previous frame completed
+    class StagingRing {
+    public:
+        TV_NCM(StagingRing)
+
+        StagingRing(uint64_t capacity, std::size_t frameCount) noexcept;
+
+        ~StagingRing() = default;
+
+        void beginFrame(std::size_t frameIndex) noexcept;
+        void endFrame(std::size_t frameIndex) noexcept;
+        [[nodiscard]] std::optional<uint64_t> allocate(uint64_t size, uint64_t alignment) noexcept;
+        [[nodiscard]] uint64_t getCapacity() const noexcept;
+
+    private:
+        uint64_t _capacity;
+        // monotonic positions, the physical offset is position % capacity
+        uint64_t _head;
+        uint64_t _tail;
+        std::vector<uint64_t> _frameEnds;
+    };
+}
@@ -0,0 +1,382 @@
+#include "bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "../jobs/job_system.hpp"
+#include "../utility/config.hpp"
+
+namespace tv {
+    namespace {
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+
+        struct Bounds {
+            glm::vec3 min{ infinity };
+            glm::vec3 max{ -infinity };
+
+            void grow(const glm::vec3& point) noexcept {
+                min = glm::min(min, point);
+                max = glm::max(max, point);
+            }
+
+            void grow(const glm::vec3& otherMin, const glm::vec3& otherMax) noexcept {
+                min = glm::min(min, otherMin);
+                max = glm::max(max, otherMax);
+            }
+
+            float area() const noexcept {
+                if (min.x > max.x)
+                    return 0.0f;
+
+                const glm::vec3 extent = max - min;
+                return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+            }
+        };
+
+        float surfaceArea(const glm::vec3& min, const glm::vec3& max) noexcept {
+            return Bounds{ min, max }.area();
+        }
+
+        bool raySphere(const glm::vec3& origin, const glm::vec3& direction, const glm::vec4& sphere, float& distance) noexcept {
+            const glm::vec3 offset = origin - glm::vec3(sphere);
+            const float b = glm::dot(offset, direction);
+            const float c = glm::dot(offset, offset) - sphere.w * sphere.w;
+            const float discriminant = b * b - c;
+            if (discriminant < 0.0f)
+                return false;
+
+            const float root = std::sqrt(discriminant);
+            distance = -b - root >= 0.0f ? -b - root : -b + root;
+            return distance >= 0.0f;
+        }
+
+        // slab test, returns the entry distance or infinity on a miss
+        float rayBox(const glm::vec3& origin, const glm::vec3& inverseDirection, const glm::vec3& min, const glm::vec3& max, float maxDistance) noexcept {
+            const glm::vec3 t0 = (min - origin) * inverseDirection;
+            const glm::vec3 t1 = (max - origin) * inverseDirection;
+            const glm::vec3 near = glm::min(t0, t1);
+            const glm::vec3 far = glm::max(t0, t1);
+            const float enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+            const float exit = std::min(std::min(far.x, far.y), std::min(far.z, maxDistance));
+            return enter <= exit ? enter : infinity;
+        }
+    }
+
+    Bvh::Bvh() noexcept
+        : _cost{ 0.0f }
+    {}
+
+    void Bvh::resize(std::size_t idCount) noexcept {
+        _spheres.resize(idCount, glm::vec4(0.0f, 0.0f, 0.0f, -1.0f));
+        _inTree.resize(idCount, 0);
+    }
+
+    void Bvh::setSphere(uint32_t id, const glm::vec4& sphere) noexcept {
+        _spheres[id] = sphere;
+    }
+
+    const glm::vec4& Bvh::getSphere(uint32_t id) const noexcept {
+        return _spheres[id];
+    }
+
+    std::size_t Bvh::getIdCount() const noexcept {
+        return _spheres.size();
+    }
+
+    void Bvh::build() noexcept {
+        _primitives.clear();
+        std::fill(_inTree.begin(), _inTree.end(), 0);
+        for (uint32_t id = 0; id < _spheres.size(); ++id) {
+            if (_spheres[id].w >= 0.0f) {
+                _primitives.push_back(id);
+                _inTree[id] = 1;
+            }
+        }
+
+        _nodes.clear();
+        _nodes.reserve(2 * _primitives.size() / constants::config::SCENE_BVH_MAX_LEAF_SIZE + 1);
+        _nodes.push_back(BvhNode{ glm::vec3(0.0f), 0, glm::vec3(0.0f), static_cast<uint32_t>(_primitives.size()), 0 });
+
+        constexpr std::size_t binCount = constants::config::SCENE_BVH_BIN_COUNT;
+        std::vector<uint32_t> stack{ 0 };
+        while (!stack.empty()) {
+            const uint32_t nodeIndex = stack.back();
+            stack.pop_back();
+
+            BvhNode& node = _nodes[nodeIndex];
+            Bounds bounds;
+            Bounds centroids;
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const glm::vec4& sphere = _spheres[_primitives[i]];
+                bounds.grow(glm::vec3(sphere) - sphere.w, glm::vec3(sphere) + sphere.w);
+                centroids.grow(glm::vec3(sphere));
+            }
+            node.min = bounds.min;
+            node.max = bounds.max;
+
+            if (node.count <= constants::config::SCENE_BVH_MAX_LEAF_SIZE)
+                continue;
+
+            // bin centroids along every axis and take the cheapest plane by surface area heuristic
+            int bestAxis = -1;
+            std::size_t bestSplit = 0;
+            float bestCost = infinity;
+            for (int axis = 0; axis < 3; ++axis) {
+                const float extent = centroids.max[axis] - centroids.min[axis];
+                if (extent <= 0.0f)
+                    continue;
+
+                std::array<Bounds, binCount> bins{};
+                std::array<uint32_t, binCount> counts{};
+                const float scale = static_cast<float>(binCount) / extent;
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    const glm::vec4& sphere = _spheres[_primitives[i]];
+                    const std::size_t bin = std::min(binCount - 1, static_cast<std::size_t>((sphere[axis] - centroids.min[axis]) * scale));
+                    bins[bin].grow(glm::vec3(sphere) - sphere.w, glm::vec3(sphere) + sphere.w);
+                    ++counts[bin];
+                }
+
+                std::array<float, binCount> rightCosts{};
+                Bounds right;
+                uint32_t rightCount = 0;
+                for (std::size_t bin = binCount - 1; bin > 0; --bin) {
+                    right.grow(bins[bin].min, bins[bin].max);
+                    rightCount += counts[bin];
+                    rightCosts[bin] = right.area() * static_cast<float>(rightCount);
+                }
+
+                Bounds left;
+                uint32_t leftCount = 0;
+                for (std::size_t split = 1; split < binCount; ++split) {
+                    left.grow(bins[split - 1].min, bins[split - 1].max);
+                    leftCount += counts[split - 1];
+                    const float cost = left.area() * static_cast<float>(leftCount) + rightCosts[split];
+                    if (leftCount > 0 && leftCount < node.count && cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+
+            uint32_t* begin = _primitives.data() + node.first;
+            uint32_t* end = begin + node.count;
+            uint32_t* middle;
+            if (bestAxis >= 0) {
+                const float scale = static_cast<float>(binCount) / (centroids.max[bestAxis] - centroids.min[bestAxis]);
+                const float minimum = centroids.min[bestAxis];
+                middle = std::partition(begin, end, [&](uint32_t id) {
+                    const std::size_t bin = std::min(binCount - 1, static_cast<std::size_t>((_spheres[id][bestAxis] - minimum) * scale));
+                    return bin < bestSplit;
+                });
+            } else {
+                // coincident centroids, any split is as good as another
+                middle = begin + node.count / 2;
+            }
+
+            const uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+            const uint32_t left = static_cast<uint32_t>(_nodes.size());
+            node.left = left;
+            const BvhNode leftNode{ glm::vec3(0.0f), node.first, glm::vec3(0.0f), leftCount, 0 };
+            const BvhNode rightNode{ glm::vec3(0.0f), node.first + leftCount, glm::vec3(0.0f), node.count - leftCount, 0 };
+            _nodes.push_back(leftNode);
+            _nodes.push_back(rightNode);
+            stack.push_back(left);
+            stack.push_back(left + 1);
+        }
+
+        updateCost();
+    }
+
+    void Bvh::refit() noexcept {
+        // children are always allocated after their parent, so a reverse sweep is bottom-up
+        for (std::size_t i = _nodes.size(); i-- > 0;) {
+            BvhNode& node = _nodes[i];
+            Bounds bounds;
+            if (node.left == 0) {
+                for (uint32_t p = node.first; p < node.first + node.count; ++p) {
+                    const glm::vec4& sphere = _spheres[_primitives[p]];
+                    if (sphere.w >= 0.0f)
+                        bounds.grow(glm::vec3(sphere) - sphere.w, glm::vec3(sphere) + sphere.w);
+                }
+            } else {
+                bounds.grow(_nodes[node.left].min, _nodes[node.left].max);
+                bounds.grow(_nodes[node.left + 1].min, _nodes[node.left + 1].max);
+            }
+            node.min = bounds.min;
+            node.max = bounds.max;
+        }
+
+        updateCost();
+    }
+
+    bool Bvh::contains(uint32_t id) const noexcept {
+        return _inTree[id];
+    }
+
+    float Bvh::getCost() const noexcept {
+        return _cost;
+    }
+
+    void Bvh::cull(const Frustum& frustum, std::vector<uint32_t>& visible) const noexcept {
+        if (_nodes.empty())
+            return;
+
+        if (_spheres.size() < constants::config::SCENE_BVH_PARALLEL_CULL_MIN_IDS) {
+            cullSubtree(0, frustum, visible);
+            return;
+        }
+
+        // split the top of the tree breadth first and cull the subtrees as separate jobs
+        _cullRoots.assign(1, 0);
+        std::vector<uint32_t> next;
+        while (_cullRoots.size() < constants::config::SCENE_BVH_CULL_SUBTREES) {
+            next.clear();
+            for (const uint32_t root : _cullRoots) {
+                const BvhNode& node = _nodes[root];
+                if (node.left != 0) {
+                    next.push_back(node.left);
+                    next.push_back(node.left + 1);
+                } else {
+                    next.push_back(root);
+                }
+            }
+
+            if (next.size() == _cullRoots.size())
+                break;
+            _cullRoots.swap(next);
+        }
+
+        _cullResults.resize(_cullRoots.size());
+        JobSystem::instance().parallelFor(_cullRoots.size(), 1, [this, &frustum](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                _cullResults[i].clear();
+                cullSubtree(_cullRoots[i], frustum, _cullResults[i]);
+            }
+        });
+
+        for (std::size_t i = 0; i < _cullRoots.size(); ++i)
+            visible.insert(visible.end(), _cullResults[i].begin(), _cullResults[i].end());
+    }
+
+    void Bvh::cullSubtree(uint32_t root, const Frustum& frustum, std::vector<uint32_t>& visible) const noexcept {
+        std::vector<uint32_t> stack{ root };
+        while (!stack.empty()) {
+            const BvhNode& node = _nodes[stack.back()];
+            stack.pop_back();
+            if (node.min.x > node.max.x)
+                continue;
+
+            const FrustumTest test = frustum.testBox(node.min, node.max);
+            if (test == FrustumTest::outside)
+                continue;
+
+            if (test == FrustumTest::inside) {
+                emitRange(node, visible);
+            } else if (node.left != 0) {
+                stack.push_back(node.left);
+                stack.push_back(node.left + 1);
+            } else {
+                for (uint32_t p = node.first; p < node.first + node.count; ++p) {
+                    const glm::vec4& sphere = _spheres[_primitives[p]];
+                    if (sphere.w >= 0.0f && frustum.intersectsSphere(glm::vec3(sphere), sphere.w))
+                        visible.push_back(_primitives[p]);
+                }
+            }
+        }
+    }
+
+    std::optional<BvhHit> Bvh::raycast(const glm::vec3& origin, const glm::vec3& direction) const noexcept {
+        if (_nodes.empty())
+            return std::nullopt;
+
+        const glm::vec3 unitDirection = glm::normalize(direction);
+        const glm::vec3 inverseDirection = 1.0f / unitDirection;
+        std::optional<BvhHit> closest;
+        float closestDistance = infinity;
+
+        std::vector<uint32_t> stack{ 0 };
+        while (!stack.empty()) {
+            const BvhNode& node = _nodes[stack.back()];
+            stack.pop_back();
+            if (rayBox(origin, inverseDirection, node.min, node.max, closestDistance) == infinity)
+                continue;
+
+            if (node.left == 0) {
+                for (uint32_t p = node.first; p < node.first + node.count; ++p) {
+                    const glm::vec4& sphere = _spheres[_primitives[p]];
+                    float distance;
+                    if (sphere.w >= 0.0f && raySphere(origin, unitDirection, sphere, distance) && distance < closestDistance) {
+                        closestDistance = distance;
+                        closest = BvhHit{ _primitives[p], distance };
+                    }
+                }
+                continue;
+            }
+
+            // nearer child on top of the stack, so hits found there prune the farther one
+            const BvhNode& left = _nodes[node.left];
+            const BvhNode& right = _nodes[node.left + 1];
+            const float leftDistance = rayBox(origin, inverseDirection, left.min, left.max, closestDistance);
+            const float rightDistance = rayBox(origin, inverseDirection, right.min, right.max, closestDistance);
+            if (leftDistance <= rightDistance) {
+                stack.push_back(node.left + 1);
+                stack.push_back(node.left);
+            } else {
+                stack.push_back(node.left);
+                stack.push_back(node.left + 1);
+            }
+        }
+
+        return closest;
+    }
+
+    void Bvh::queryPoint(const glm::vec3& point, std::vector<uint32_t>& hits) const noexcept {
+        if (_nodes.empty())
+            return;
+
+        std::vector<uint32_t> stack{ 0 };
+        while (!stack.empty()) {
+            const BvhNode& node = _nodes[stack.back()];
+            stack.pop_back();
+            if (glm::any(glm::lessThan(point, node.min)) || glm::any(glm::greaterThan(point, node.max)))
+                continue;
+
+            if (node.left != 0) {
+                stack.push_back(node.left);
+                stack.push_back(node.left + 1);
+                continue;
+            }
+
+            for (uint32_t p = node.first; p < node.first + node.count; ++p) {
+                const glm::vec4& sphere = _spheres[_primitives[p]];
+                const glm::vec3 offset = point - glm::vec3(sphere);
+                if (sphere.w >= 0.0f && glm::dot(offset, offset) <= sphere.w * sphere.w)
+                    hits.push_back(_primitives[p]);
+            }
+        }
+    }
+
+    void Bvh::updateCost() noexcept {
+        _cost = 0.0f;
+        if (_nodes.empty())
+            return;
+
+        const float rootArea = surfaceArea(_nodes[0].min, _nodes[0].max);
+        if (rootArea <= 0.0f)
+            return;
+
+        for (const BvhNode& node : _nodes) {
+            const float weight = node.left == 0 ? static_cast<float>(node.count) : 1.0f;
+            _cost += weight * surfaceArea(node.min, node.max) / rootArea;
+        }
+    }
+
+    void Bvh::emitRange(const BvhNode& node, std::vector<uint32_t>& visible) const noexcept {
+        for (uint32_t p = node.first; p < node.first + node.count; ++p)
+            if (_spheres[_primitives[p]].w >= 0.0f)
+                visible.push_back(_primitives[p]);
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "frustum.hpp"
+
+namespace tv {
+    struct BvhNode {
+        glm::vec3 min;
+        // primitive range of the whole subtree, so a node fully inside a query is emitted without descending
+        uint32_t first;
+        glm::vec3 max;
+        uint32_t count;
+        // index of the left child, the right one follows it; 0 for leaves since the root is never a child
+        uint32_t left;
+    };
+
+    struct BvhHit {
+        uint32_t id;
+        float distance;
+    };
+
+    // bounding volume hierarchy over spheres addressed by id; a negative radius marks an unused id.
+    // Moving spheres are handled by refitting the node bounds, the topology only changes on build
+    class Bvh {
+    public:
+        Bvh() noexcept;
+
+        ~Bvh() = default;
+
+        void resize(std::size_t idCount) noexcept;
+        void setSphere(uint32_t id, const glm::vec4& sphere) noexcept;
+        [[nodiscard]] const glm::vec4& getSphere(uint32_t id) const noexcept;
+        [[nodiscard]] std::size_t getIdCount() const noexcept;
+
+        // binned SAH build over every used id
+        void build() noexcept;
+        // recomputes node bounds bottom-up, ids unused at build time stay out of the tree
+        void refit() noexcept;
+        [[nodiscard]] bool contains(uint32_t id) const noexcept;
+        // SAH cost of the current tree relative to its root, grows as refits loosen the bounds
+        [[nodiscard]] float getCost() const noexcept;
+
+        // large trees are culled as parallel jobs over their top subtrees
+        void cull(const Frustum& frustum, std::vector<uint32_t>& visible) const noexcept;
+        [[nodiscard]] std::optional<BvhHit> raycast(const glm::vec3& origin, const glm::vec3& direction) const noexcept;
+        void queryPoint(const glm::vec3& point, std::vector<uint32_t>& hits) const noexcept;
+
+    private:
+        void updateCost() noexcept;
+        void cullSubtree(uint32_t root, const Frustum& frustum, std::vector<uint32_t>& visible) const noexcept;
+        void emitRange(const BvhNode& node, std::vector<uint32_t>& visible) const noexcept;
+
+        std::vector<glm::vec4> _spheres;
+        std::vector<BvhNode> _nodes;
+        std::vector<uint32_t> _primitives;
+        std::vector<uint8_t> _inTree;
+        // per cull scratch, one result list per subtree job
+        mutable std::vector<uint32_t> _cullRoots;
+        mutable std::vector<std::vector<uint32_t>> _cullResults;
+        float _cost;
+    };
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm.hpp>
+
+#include "entity_store.hpp"
+
+namespace tv::component {
+    // local transform, one float array per axis so the matrix kernel loads them directly
+    struct Position {};
+    struct Rotation {};
+    struct Scale {};
+
+    struct WorldTransform {};
+
+    struct Node {
+        Entity parent;
+        // hierarchy depth, also the archetype group so parents are visited before their children
+        uint32_t depth;
+        uint32_t childCount;
+    };
+}
+
+namespace tv {
+    template<>
+    struct ComponentLayout<component::Position> {
+        using Element = float;
+        static constexpr std::size_t lanes = 3;
+    };
+
+    template<>
+    struct ComponentLayout<component::Rotation> {
+        using Element = float;
+        static constexpr std::size_t lanes = 4;
+    };
+
+    template<>
+    struct ComponentLayout<component::Scale> {
+        using Element = float;
+        static constexpr std::size_t lanes = 3;
+    };
+
+    template<>
+    struct ComponentLayout<component::WorldTransform> {
+        using Element = glm::mat4;
+        static constexpr std::size_t lanes = 1;
+    };
+}
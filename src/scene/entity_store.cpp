@@ -0,0 +1,225 @@
+#include "entity_store.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace tv {
+    namespace {
+        std::vector<ComponentInfo>& componentRegistry() noexcept {
+            static std::vector<ComponentInfo> registry;
+            return registry;
+        }
+
+        std::size_t alignUp(std::size_t value, std::size_t alignment) noexcept {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        // every lane array starts on its own cache line
+        std::size_t chunkBytes(ComponentMask mask, std::size_t capacity) noexcept {
+            std::size_t bytes = alignUp(capacity * sizeof(Entity), constants::config::SCENE_CHUNK_ALIGNMENT);
+            for (std::size_t id = 0; id < componentRegistry().size(); ++id) {
+                if (mask & (ComponentMask{ 1 } << id)) {
+                    const ComponentInfo& info = componentRegistry()[id];
+                    bytes += info.lanes * alignUp(capacity * info.elementSize, constants::config::SCENE_CHUNK_ALIGNMENT);
+                }
+            }
+
+            return bytes;
+        }
+    }
+
+    std::size_t registerComponent(const ComponentInfo& info) noexcept {
+        assert(componentRegistry().size() < maxComponents);
+        componentRegistry().push_back(info);
+        return componentRegistry().size() - 1;
+    }
+
+    const ComponentInfo& getComponentInfo(std::size_t componentId) noexcept {
+        return componentRegistry()[componentId];
+    }
+
+    EntityStore::EntityStore() noexcept
+        : _entityCount{ 0 },
+          _version{ 0 }
+    {}
+
+    Entity EntityStore::create(ComponentMask mask, uint32_t group) noexcept {
+        Archetype& archetype = findArchetype(mask, group);
+        ArchetypeChunk& chunk = archetype.available.empty() ? acquireChunk(archetype) : *archetype.available.back();
+
+        uint32_t index;
+        if (_freeRecords.empty()) {
+            index = static_cast<uint32_t>(_records.size());
+            _records.push_back({ nullptr, 0, 0 });
+        } else {
+            index = _freeRecords.back();
+            _freeRecords.pop_back();
+        }
+
+        EntityRecord& record = _records[index];
+        record.chunk = &chunk;
+        record.row = static_cast<uint32_t>(chunk.count);
+
+        const Entity entity{ index, record.generation };
+        getEntities(chunk)[chunk.count] = entity;
+        ++chunk.count;
+        chunk.structureVersion = ++_version;
+        if (chunk.count == archetype.capacity)
+            archetype.available.pop_back();
+
+        ++_entityCount;
+        return entity;
+    }
+
+    void EntityStore::destroy(Entity entity) noexcept {
+        assert(alive(entity));
+        EntityRecord& record = _records[entity.index];
+        ArchetypeChunk& chunk = *record.chunk;
+        Archetype& archetype = *chunk.archetype;
+
+        const std::size_t last = chunk.count - 1;
+        chunk.structureVersion = ++_version;
+        if (record.row != last) {
+            for (std::size_t id = 0; id < maxComponents; ++id) {
+                if (!(archetype.mask & (ComponentMask{ 1 } << id)))
+                    continue;
+
+                const std::size_t elementSize = getComponentInfo(id).elementSize;
+                for (std::size_t lane = 0; lane < getComponentInfo(id).lanes; ++lane) {
+                    std::byte* array = chunk.data.data() + laneOffset(chunk, id, lane);
+                    std::memcpy(array + record.row * elementSize, array + last * elementSize, elementSize);
+                }
+                chunk.componentVersions[id] = chunk.structureVersion;
+            }
+
+            Entity* entities = getEntities(chunk);
+            entities[record.row] = entities[last];
+            _records[entities[record.row].index].row = record.row;
+        }
+
+        if (chunk.count == archetype.capacity)
+            archetype.available.push_back(&chunk);
+        --chunk.count;
+
+        record.chunk = nullptr;
+        ++record.generation;
+        _freeRecords.push_back(entity.index);
+        --_entityCount;
+
+        if (chunk.count == 0)
+            releaseChunk(chunk);
+    }
+
+    bool EntityStore::alive(Entity entity) const noexcept {
+        return entity.index < _records.size()
+            && _records[entity.index].generation == entity.generation
+            && _records[entity.index].chunk;
+    }
+
+    ArchetypeChunk& EntityStore::getChunk(Entity entity) const noexcept {
+        assert(alive(entity));
+        return *_records[entity.index].chunk;
+    }
+
+    std::size_t EntityStore::getRow(Entity entity) const noexcept {
+        assert(alive(entity));
+        return _records[entity.index].row;
+    }
+
+    Entity EntityStore::getEntity(const ArchetypeChunk& chunk, std::size_t row) const noexcept {
+        assert(chunk.archetype && row < chunk.count);
+        return reinterpret_cast<const Entity*>(chunk.data.data() + chunk.archetype->entitiesOffset)[row];
+    }
+
+    std::size_t EntityStore::getEntityCount() const noexcept {
+        return _entityCount;
+    }
+
+    std::size_t EntityStore::getChunkCount() const noexcept {
+        return _chunks.size();
+    }
+
+    const ArchetypeChunk& EntityStore::getChunk(std::size_t index) const noexcept {
+        return *_chunks[index];
+    }
+
+    uint64_t EntityStore::getVersion() const noexcept {
+        return _version;
+    }
+
+    Archetype& EntityStore::findArchetype(ComponentMask mask, uint32_t group) noexcept {
+        for (const auto& archetype : _archetypes)
+            if (archetype->mask == mask && archetype->group == group)
+                return *archetype;
+
+        auto archetype = std::make_unique<Archetype>();
+        archetype->mask = mask;
+        archetype->group = group;
+
+        // as many rows as fit, capped so a chunk never spans more than one consumer slot
+        archetype->capacity = constants::config::SCENE_CHUNK_CAPACITY;
+        while (archetype->capacity > 1 && chunkBytes(mask, archetype->capacity) > constants::config::SCENE_CHUNK_BYTES)
+            --archetype->capacity;
+        assert(chunkBytes(mask, archetype->capacity) <= constants::config::SCENE_CHUNK_BYTES);
+
+        std::size_t offset = 0;
+        archetype->entitiesOffset = offset;
+        offset += alignUp(archetype->capacity * sizeof(Entity), constants::config::SCENE_CHUNK_ALIGNMENT);
+        for (std::size_t id = 0; id < componentRegistry().size(); ++id) {
+            if (!(mask & (ComponentMask{ 1 } << id)))
+                continue;
+
+            const ComponentInfo& info = componentRegistry()[id];
+            archetype->offsets[id] = offset;
+            archetype->laneStrides[id] = alignUp(archetype->capacity * info.elementSize, constants::config::SCENE_CHUNK_ALIGNMENT);
+            offset += info.lanes * archetype->laneStrides[id];
+        }
+
+        const auto position = std::upper_bound(_archetypes.begin(), _archetypes.end(), group, [](uint32_t value, const auto& other) {
+            return value < other->group;
+        });
+        return **_archetypes.insert(position, std::move(archetype));
+    }
+
+    ArchetypeChunk& EntityStore::acquireChunk(Archetype& archetype) noexcept {
+        ArchetypeChunk* chunk;
+        if (_freeChunks.empty()) {
+            _chunks.push_back(std::make_unique<ArchetypeChunk>());
+            chunk = _chunks.back().get();
+            chunk->index = _chunks.size() - 1;
+        } else {
+            chunk = _chunks[_freeChunks.back()].get();
+            _freeChunks.pop_back();
+        }
+
+        chunk->archetype = &archetype;
+        chunk->count = 0;
+        chunk->componentVersions.fill(++_version);
+        chunk->structureVersion = _version;
+        archetype.chunks.push_back(chunk);
+        archetype.available.push_back(chunk);
+        return *chunk;
+    }
+
+    void EntityStore::releaseChunk(ArchetypeChunk& chunk) noexcept {
+        Archetype& archetype = *chunk.archetype;
+        std::erase(archetype.chunks, &chunk);
+        std::erase(archetype.available, &chunk);
+
+        // the chunk object stays allocated, so its index remains a valid slot
+        chunk.archetype = nullptr;
+        chunk.structureVersion = ++_version;
+        _freeChunks.push_back(chunk.index);
+    }
+
+    std::size_t EntityStore::laneOffset(const ArchetypeChunk& chunk, std::size_t componentId, std::size_t lane) const noexcept {
+        assert(chunk.archetype && (chunk.archetype->mask & (ComponentMask{ 1 } << componentId)));
+        return chunk.archetype->offsets[componentId] + lane * chunk.archetype->laneStrides[componentId];
+    }
+
+    Entity* EntityStore::getEntities(ArchetypeChunk& chunk) const noexcept {
+        return reinterpret_cast<Entity*>(chunk.data.data() + chunk.archetype->entitiesOffset);
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "../utility/config.hpp"
+#include "../utility/types.hpp"
+
+namespace tv {
+    // stable handle, the generation tells a live entity from one that reused its index
+    struct Entity {
+        uint32_t index;
+        uint32_t generation;
+
+        bool operator==(const Entity&) const = default;
+    };
+
+    inline constexpr Entity nullEntity{ std::numeric_limits<uint32_t>::max(), 0 };
+
+    using ComponentMask = uint32_t;
+    inline constexpr std::size_t maxComponents = 32;
+
+    // a component is stored as `lanes` packed arrays of Element per chunk,
+    // so e.g. a position can be kept as separate x, y and z arrays
+    template<typename T>
+    struct ComponentLayout {
+        using Element = T;
+        static constexpr std::size_t lanes = 1;
+    };
+
+    struct ComponentInfo {
+        std::size_t elementSize;
+        std::size_t lanes;
+    };
+
+    [[nodiscard]] std::size_t registerComponent(const ComponentInfo& info) noexcept;
+    [[nodiscard]] const ComponentInfo& getComponentInfo(std::size_t componentId) noexcept;
+
+    template<typename T>
+    std::size_t componentId() noexcept {
+        using Element = typename ComponentLayout<T>::Element;
+        static_assert(std::is_trivially_copyable_v<Element>);
+        static_assert(alignof(Element) <= constants::config::SCENE_CHUNK_ALIGNMENT);
+        static const std::size_t id = registerComponent({ sizeof(Element), ComponentLayout<T>::lanes });
+        return id;
+    }
+
+    template<typename... Ts>
+    ComponentMask componentMask() noexcept {
+        return ((ComponentMask{ 1 } << componentId<Ts>()) | ...);
+    }
+
+    struct Archetype;
+
+    // the metadata comes first, so the only padding is the gap up to the aligned data and none trails it
+    struct ArchetypeChunk {
+        // null while the chunk sits in the free list
+        Archetype* archetype;
+        // stable for the chunk's lifetime, consumers may use it as a slot index
+        std::size_t index;
+        std::size_t count;
+        // store version of the last write per component, and of the last add or remove
+        std::array<uint64_t, maxComponents> componentVersions;
+        uint64_t structureVersion;
+        alignas(constants::config::SCENE_CHUNK_ALIGNMENT) std::array<std::byte, constants::config::SCENE_CHUNK_BYTES> data;
+    };
+
+    static_assert(constants::config::SCENE_CHUNK_BYTES % constants::config::SCENE_CHUNK_ALIGNMENT == 0);
+    static_assert(offsetof(ArchetypeChunk, data) + sizeof(ArchetypeChunk::data) == sizeof(ArchetypeChunk));
+
+    struct Archetype {
+        ComponentMask mask;
+        uint32_t group;
+        std::size_t capacity;
+        // byte offset of each component's first lane, lanes follow each other laneStrides apart
+        std::array<std::size_t, maxComponents> offsets;
+        std::array<std::size_t, maxComponents> laneStrides;
+        std::size_t entitiesOffset;
+        std::vector<ArchetypeChunk*> chunks;
+        // chunks with at least one free row
+        std::vector<ArchetypeChunk*> available;
+    };
+
+    // entities grouped by component set into fixed-size chunks of packed component arrays;
+    // removal swaps the chunk's last row into the hole, so chunks stay dense
+    class EntityStore {
+    public:
+        TV_NCM(EntityStore)
+
+        EntityStore() noexcept;
+
+        ~EntityStore() = default;
+
+        // archetypes are keyed by mask and group, queries visit groups in ascending order
+        [[nodiscard]] Entity create(ComponentMask mask, uint32_t group = 0) noexcept;
+        void destroy(Entity entity) noexcept;
+        [[nodiscard]] bool alive(Entity entity) const noexcept;
+        [[nodiscard]] ArchetypeChunk& getChunk(Entity entity) const noexcept;
+        [[nodiscard]] std::size_t getRow(Entity entity) const noexcept;
+        [[nodiscard]] Entity getEntity(const ArchetypeChunk& chunk, std::size_t row) const noexcept;
+        [[nodiscard]] std::size_t getEntityCount() const noexcept;
+        [[nodiscard]] std::size_t getChunkCount() const noexcept;
+        [[nodiscard]] const ArchetypeChunk& getChunk(std::size_t index) const noexcept;
+        [[nodiscard]] uint64_t getVersion() const noexcept;
+
+        template<typename T>
+        const typename ComponentLayout<T>::Element* read(const ArchetypeChunk& chunk, std::size_t lane = 0) const noexcept {
+            using Element = typename ComponentLayout<T>::Element;
+            return reinterpret_cast<const Element*>(chunk.data.data() + laneOffset(chunk, componentId<T>(), lane));
+        }
+
+        // stamps the component's chunk version, readers compare it against the version they last saw
+        template<typename T>
+        typename ComponentLayout<T>::Element* write(ArchetypeChunk& chunk, std::size_t lane = 0) noexcept {
+            using Element = typename ComponentLayout<T>::Element;
+            const std::size_t id = componentId<T>();
+            chunk.componentVersions[id] = ++_version;
+            return reinterpret_cast<Element*>(chunk.data.data() + laneOffset(chunk, id, lane));
+        }
+
+        template<typename T>
+        static bool changedSince(const ArchetypeChunk& chunk, uint64_t version) noexcept {
+            return chunk.componentVersions[componentId<T>()] > version;
+        }
+
+        template<typename F>
+        void forEachChunk(ComponentMask mask, F&& f) {
+            for (const auto& archetype : _archetypes)
+                if ((archetype->mask & mask) == mask)
+                    for (ArchetypeChunk* chunk : archetype->chunks)
+                        f(*chunk);
+        }
+
+    private:
+        struct EntityRecord {
+            ArchetypeChunk* chunk;
+            uint32_t row;
+            uint32_t generation;
+        };
+
+        [[nodiscard]] Archetype& findArchetype(ComponentMask mask, uint32_t group) noexcept;
+        [[nodiscard]] ArchetypeChunk& acquireChunk(Archetype& archetype) noexcept;
+        void releaseChunk(ArchetypeChunk& chunk) noexcept;
+        [[nodiscard]] std::size_t laneOffset(const ArchetypeChunk& chunk, std::size_t componentId, std::size_t lane) const noexcept;
+        [[nodiscard]] Entity* getEntities(ArchetypeChunk& chunk) const noexcept;
+
+        // sorted by group
+        std::vector<std::unique_ptr<Archetype>> _archetypes;
+        std::vector<std::unique_ptr<ArchetypeChunk>> _chunks;
+        std::vector<std::size_t> _freeChunks;
+        std::vector<EntityRecord> _records;
+        std::vector<uint32_t> _freeRecords;
+        std::size_t _entityCount;
+        // atomic since chunks are written from several transform jobs at once
+        std::atomic<uint64_t> _version;
+    };
+}
@@ -0,0 +1,46 @@
+#include "frustum.hpp"
+
+namespace tv {
+    Frustum::Frustum(const glm::mat4& viewProjection) noexcept {
+        // Gribb-Hartmann extraction, Vulkan clip space (0 <= z <= w)
+        const glm::mat4 m = glm::transpose(viewProjection);
+        _planes[0] = m[3] + m[0];
+        _planes[1] = m[3] - m[0];
+        _planes[2] = m[3] + m[1];
+        _planes[3] = m[3] - m[1];
+        _planes[4] = m[2];
+        _planes[5] = m[3] - m[2];
+
+        for (auto& plane : _planes)
+            plane /= glm::length(glm::vec3(plane));
+    }
+
+    const std::array<glm::vec4, 6>& Frustum::getPlanes() const noexcept {
+        return _planes;
+    }
+
+    bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const noexcept {
+        for (const auto& plane : _planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                return false;
+        }
+
+        return true;
+    }
+
+    FrustumTest Frustum::testBox(const glm::vec3& min, const glm::vec3& max) const noexcept {
+        FrustumTest result = FrustumTest::inside;
+        for (const auto& plane : _planes) {
+            const glm::vec3 normal{ plane };
+            // the corners furthest along and against the plane normal
+            const glm::vec3 positive = glm::mix(min, max, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+            const glm::vec3 negative = glm::mix(max, min, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+            if (glm::dot(normal, positive) + plane.w < 0.0f)
+                return FrustumTest::outside;
+            if (glm::dot(normal, negative) + plane.w < 0.0f)
+                result = FrustumTest::intersects;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+
+#include <glm.hpp>
+
+namespace tv {
+    enum class FrustumTest {
+        outside,
+        intersects,
+        inside
+    };
+
+    class Frustum {
+    public:
+        explicit Frustum(const glm::mat4& viewProjection) noexcept;
+
+        ~Frustum() = default;
+
+        const std::array<glm::vec4, 6>& getPlanes() const noexcept;
+        bool intersectsSphere(const glm::vec3& center, float radius) const noexcept;
+        FrustumTest testBox(const glm::vec3& min, const glm::vec3& max) const noexcept;
+
+    private:
+        std::array<glm::vec4, 6> _planes;
+    };
+}
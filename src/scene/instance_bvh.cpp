@@ -0,0 +1,58 @@
+#include "instance_bvh.hpp"
+
+#include <algorithm>
+
+#include "../utility/config.hpp"
+
+namespace tv {
+    InstanceBvh::InstanceBvh() noexcept
+        : _rebuild{ false },
+          _buildCost{ 0.0f }
+    {}
+
+    bool InstanceBvh::resize(std::size_t instanceCount) noexcept {
+        if (_bvh.getIdCount() == instanceCount)
+            return false;
+
+        _bvh.resize(instanceCount);
+        _rebuild.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    void InstanceBvh::updateChunk(std::size_t chunkIndex, const glm::mat4* worlds, std::size_t count, float radius) noexcept {
+        constexpr std::size_t capacity = constants::config::SCENE_CHUNK_CAPACITY;
+        bool grown = false;
+        for (std::size_t row = 0; row < capacity; ++row) {
+            const auto id = static_cast<uint32_t>(chunkIndex * capacity + row);
+            glm::vec4 sphere{ 0.0f, 0.0f, 0.0f, -1.0f };
+            if (row < count && worlds[row][3][3] != 0.0f) {
+                // same bound as the GPU cull shader: the base radius scaled by the largest axis
+                const glm::mat4& world = worlds[row];
+                const float scale = std::max(glm::length(glm::vec3(world[0])), std::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+                sphere = glm::vec4(glm::vec3(world[3]), radius * scale);
+                grown = grown || !_bvh.contains(id);
+            }
+            _bvh.setSphere(id, sphere);
+        }
+
+        if (grown)
+            _rebuild.store(true, std::memory_order_relaxed);
+    }
+
+    void InstanceBvh::commit() noexcept {
+        bool rebuild = _rebuild.exchange(false, std::memory_order_relaxed);
+        if (!rebuild) {
+            _bvh.refit();
+            rebuild = _bvh.getCost() > _buildCost * constants::config::SCENE_BVH_REBUILD_COST_RATIO;
+        }
+
+        if (rebuild) {
+            _bvh.build();
+            _buildCost = _bvh.getCost();
+        }
+    }
+
+    const Bvh& InstanceBvh::getBvh() const noexcept {
+        return _bvh;
+    }
+}
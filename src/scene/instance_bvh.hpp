@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include <glm.hpp>
+
+#include "bvh.hpp"
+
+namespace tv {
+    // BVH over instance slots, SCENE_CHUNK_CAPACITY per chunk, kept current chunk by chunk.
+    // Moved instances are refitted; a new slot coming alive or a loose tree triggers a rebuild
+    class InstanceBvh {
+    public:
+        InstanceBvh() noexcept;
+
+        ~InstanceBvh() = default;
+
+        // true when the slot count changed, every chunk has to be updated then
+        bool resize(std::size_t instanceCount) noexcept;
+        // rows from count on and zero matrices are unused slots; different chunks may be updated concurrently
+        void updateChunk(std::size_t chunkIndex, const glm::mat4* worlds, std::size_t count, float radius) noexcept;
+        // refits or rebuilds after the chunk updates
+        void commit() noexcept;
+        [[nodiscard]] const Bvh& getBvh() const noexcept;
+
+    private:
+        Bvh _bvh;
+        std::atomic<bool> _rebuild;
+        // tree cost right after the last build
+        float _buildCost;
+    };
+}
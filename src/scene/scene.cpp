@@ -1,14 +1,282 @@
 #include "scene.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "components.hpp"
+#include "transform_kernel.hpp"
+#include "../jobs/job_system.hpp"
+#include "../utility/config.hpp"
+
 namespace tv {
     Scene::Scene() noexcept
+        : _objectMask{ componentMask<component::Position, component::Rotation, component::Scale, component::WorldTransform, component::Node>() },
+          _updatedVersion{ 0 },
+          _bvhVersion{ 0 },
+          _viewProjection{ 1.0f },
+          _boundingRadius{ 0.0708f }
     {
         for (int x = -10; x < 10; x += 2)
             for (int y = -10; y < 10; y += 2)
-                _trianglePositions.emplace_back(glm::vec3((float)x / 10, (float)y / 10, 0));
+                createObject(glm::vec3((float)x / 10, (float)y / 10, 0));
+
+        updateWorldTransforms();
+    }
+
+    Scene::Scene(std::size_t triangleCount) noexcept
+        : _objectMask{ componentMask<component::Position, component::Rotation, component::Scale, component::WorldTransform, component::Node>() },
+          _updatedVersion{ 0 },
+          _bvhVersion{ 0 },
+          _viewProjection{ 1.0f },
+          _boundingRadius{ 0.0708f }
+    {
+        const auto side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(triangleCount))));
+        for (std::size_t i = 0; i < triangleCount; ++i) {
+            const float x = 2.0f * static_cast<float>(i % side) / static_cast<float>(side) - 1.0f;
+            const float y = 2.0f * static_cast<float>(i / side) / static_cast<float>(side) - 1.0f;
+            createObject(glm::vec3(x, y, 0));
+        }
+
+        updateWorldTransforms();
+    }
+
+    Entity Scene::createObject(const glm::vec3& position, Entity parent) noexcept {
+        uint32_t depth = 0;
+        if (parent != nullEntity) {
+            ArchetypeChunk& parentChunk = _entities.getChunk(parent);
+            component::Node& parentNode = _entities.write<component::Node>(parentChunk)[_entities.getRow(parent)];
+            ++parentNode.childCount;
+            depth = parentNode.depth + 1;
+        }
+
+        const Entity entity = _entities.create(_objectMask, depth);
+        ArchetypeChunk& chunk = _entities.getChunk(entity);
+        const std::size_t row = _entities.getRow(entity);
+
+        _entities.write<component::Node>(chunk)[row] = component::Node{ parent, depth, 0 };
+        _entities.write<component::WorldTransform>(chunk)[row] = glm::mat4(1.0f);
+        setPosition(entity, position);
+        setRotation(entity, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        setScale(entity, glm::vec3(1.0f));
+        return entity;
+    }
+
+    void Scene::destroyObject(Entity entity) noexcept {
+        ArchetypeChunk& chunk = _entities.getChunk(entity);
+        const component::Node node = _entities.read<component::Node>(chunk)[_entities.getRow(entity)];
+        assert(node.childCount == 0);
+
+        if (node.parent != nullEntity)
+            --_entities.write<component::Node>(_entities.getChunk(node.parent))[_entities.getRow(node.parent)].childCount;
+
+        _entities.destroy(entity);
+    }
+
+    bool Scene::alive(Entity entity) const noexcept {
+        return _entities.alive(entity);
+    }
+
+    std::size_t Scene::getObjectCount() const noexcept {
+        return _entities.getEntityCount();
+    }
+
+    Entity Scene::getParent(Entity entity) const noexcept {
+        return _entities.read<component::Node>(_entities.getChunk(entity))[_entities.getRow(entity)].parent;
+    }
+
+    glm::vec3 Scene::getPosition(Entity entity) const noexcept {
+        const ArchetypeChunk& chunk = _entities.getChunk(entity);
+        const std::size_t row = _entities.getRow(entity);
+        return glm::vec3(
+            _entities.read<component::Position>(chunk, 0)[row],
+            _entities.read<component::Position>(chunk, 1)[row],
+            _entities.read<component::Position>(chunk, 2)[row]
+        );
+    }
+
+    void Scene::setPosition(Entity entity, const glm::vec3& position) noexcept {
+        ArchetypeChunk& chunk = _entities.getChunk(entity);
+        const std::size_t row = _entities.getRow(entity);
+        for (int lane = 0; lane < 3; ++lane)
+            _entities.write<component::Position>(chunk, lane)[row] = position[lane];
+    }
+
+    void Scene::setRotation(Entity entity, const glm::quat& rotation) noexcept {
+        ArchetypeChunk& chunk = _entities.getChunk(entity);
+        const std::size_t row = _entities.getRow(entity);
+        _entities.write<component::Rotation>(chunk, 0)[row] = rotation.x;
+        _entities.write<component::Rotation>(chunk, 1)[row] = rotation.y;
+        _entities.write<component::Rotation>(chunk, 2)[row] = rotation.z;
+        _entities.write<component::Rotation>(chunk, 3)[row] = rotation.w;
+    }
+
+    void Scene::setScale(Entity entity, const glm::vec3& scale) noexcept {
+        ArchetypeChunk& chunk = _entities.getChunk(entity);
+        const std::size_t row = _entities.getRow(entity);
+        for (int lane = 0; lane < 3; ++lane)
+            _entities.write<component::Scale>(chunk, lane)[row] = scale[lane];
+    }
+
+    void Scene::updateWorldTransforms() noexcept {
+        if (_entities.getVersion() == _updatedVersion)
+            return;
+
+        const uint64_t since = _updatedVersion;
+        _updateChunks.clear();
+        _entities.forEachChunk(_objectMask, [this](ArchetypeChunk& chunk) { _updateChunks.push_back(&chunk); });
+
+        // a depth only reads world matrices of the one above, which are final by the time it starts
+        for (std::size_t first = 0; first < _updateChunks.size();) {
+            const uint32_t group = _updateChunks[first]->archetype->group;
+            std::size_t last = first + 1;
+            while (last < _updateChunks.size() && _updateChunks[last]->archetype->group == group)
+                ++last;
+
+            JobSystem::instance().parallelFor(last - first, constants::config::SCENE_TRANSFORM_JOB_CHUNKS, [this, first, since](std::size_t begin, std::size_t end) {
+                for (std::size_t i = first + begin; i < first + end; ++i)
+                    updateChunkTransforms(*_updateChunks[i], since);
+            });
+            first = last;
+        }
+
+        _updatedVersion = _entities.getVersion();
+    }
+
+    void Scene::updateChunkTransforms(ArchetypeChunk& chunk, uint64_t since) noexcept {
+        const component::Node* nodes = _entities.read<component::Node>(chunk);
+        const bool child = chunk.archetype->group > 0;
+
+        bool dirty = chunk.structureVersion > since
+            || EntityStore::changedSince<component::Position>(chunk, since)
+            || EntityStore::changedSince<component::Rotation>(chunk, since)
+            || EntityStore::changedSince<component::Scale>(chunk, since);
+
+        // parents sit in lower groups and were already visited, a changed parent chunk stamped its world version
+        const ArchetypeChunk* checked = nullptr;
+        for (std::size_t row = 0; child && !dirty && row < chunk.count; ++row) {
+            const ArchetypeChunk& parentChunk = _entities.getChunk(nodes[row].parent);
+            if (&parentChunk == checked)
+                continue;
+
+            checked = &parentChunk;
+            dirty = EntityStore::changedSince<component::WorldTransform>(parentChunk, since);
+        }
+
+        if (!dirty)
+            return;
+
+        const TransformArrays transforms{
+            _entities.read<component::Position>(chunk, 0),
+            _entities.read<component::Position>(chunk, 1),
+            _entities.read<component::Position>(chunk, 2),
+            _entities.read<component::Rotation>(chunk, 0),
+            _entities.read<component::Rotation>(chunk, 1),
+            _entities.read<component::Rotation>(chunk, 2),
+            _entities.read<component::Rotation>(chunk, 3),
+            _entities.read<component::Scale>(chunk, 0),
+            _entities.read<component::Scale>(chunk, 1),
+            _entities.read<component::Scale>(chunk, 2)
+        };
+        glm::mat4* worlds = _entities.write<component::WorldTransform>(chunk);
+        buildModelMatrices(transforms, 0, chunk.count, worlds);
+
+        for (std::size_t row = 0; child && row < chunk.count; ++row) {
+            const Entity parent = nodes[row].parent;
+            worlds[row] = _entities.read<component::WorldTransform>(_entities.getChunk(parent))[_entities.getRow(parent)] * worlds[row];
+        }
+    }
+
+    const glm::mat4& Scene::getWorldMatrix(Entity entity) const noexcept {
+        return _entities.read<component::WorldTransform>(_entities.getChunk(entity))[_entities.getRow(entity)];
+    }
+
+    std::size_t Scene::getInstanceCount() const noexcept {
+        return getChunkCount() * constants::config::SCENE_CHUNK_CAPACITY;
+    }
+
+    std::size_t Scene::getChunkCount() const noexcept {
+        return _entities.getChunkCount();
+    }
+
+    bool Scene::chunkChangedSince(std::size_t chunkIndex, uint64_t version) const noexcept {
+        const ArchetypeChunk& chunk = _entities.getChunk(chunkIndex);
+        return chunk.structureVersion > version
+            || (chunk.archetype && EntityStore::changedSince<component::WorldTransform>(chunk, version));
+    }
+
+    void Scene::copyWorldMatrices(std::size_t first, std::size_t last, glm::mat4* out) const noexcept {
+        constexpr std::size_t capacity = constants::config::SCENE_CHUNK_CAPACITY;
+        for (std::size_t chunkIndex = first / capacity; chunkIndex * capacity < last; ++chunkIndex) {
+            const std::size_t base = chunkIndex * capacity;
+            const std::size_t begin = std::max(first, base) - base;
+            const std::size_t end = std::min(last, base + capacity) - base;
+
+            const ArchetypeChunk& chunk = _entities.getChunk(chunkIndex);
+            const std::size_t live = chunk.archetype ? std::clamp(chunk.count, begin, end) : begin;
+            glm::mat4* dst = out + (base + begin - first);
+            if (live > begin)
+                streamModelMatrices(_entities.read<component::WorldTransform>(chunk) + begin, live - begin, dst);
+            if (end > live)
+                clearModelMatrices(end - live, dst + (live - begin));
+        }
+    }
+
+    uint64_t Scene::getVersion() const noexcept {
+        return _entities.getVersion();
+    }
+
+    void Scene::cull(const Frustum& frustum, std::vector<uint32_t>& visibleInstances) noexcept {
+        updateBvh();
+        _bvh.getBvh().cull(frustum, visibleInstances);
+    }
+
+    std::optional<Entity> Scene::pick(const glm::vec3& origin, const glm::vec3& direction) noexcept {
+        updateBvh();
+        const std::optional<BvhHit> hit = _bvh.getBvh().raycast(origin, direction);
+        if (!hit)
+            return std::nullopt;
+
+        return getInstanceEntity(hit->id);
+    }
+
+    void Scene::pickPoint(const glm::vec3& point, std::vector<Entity>& entities) noexcept {
+        updateBvh();
+        std::vector<uint32_t> hits;
+        _bvh.getBvh().queryPoint(point, hits);
+        for (const uint32_t instance : hits)
+            entities.push_back(getInstanceEntity(instance));
+    }
+
+    const glm::mat4& Scene::getViewProjection() const noexcept {
+        return _viewProjection;
+    }
+
+    float Scene::getBoundingRadius() const noexcept {
+        return _boundingRadius;
+    }
+
+    void Scene::updateBvh() noexcept {
+        // ids are instance slots, so chunks that merely shuffle rows are refitted rather than rebuilt
+        const bool resized = _bvh.resize(getInstanceCount());
+        if (!resized && _bvhVersion == getVersion())
+            return;
+
+        for (std::size_t chunkIndex = 0; chunkIndex < getChunkCount(); ++chunkIndex) {
+            if (!resized && !chunkChangedSince(chunkIndex, _bvhVersion))
+                continue;
+
+            const ArchetypeChunk& chunk = _entities.getChunk(chunkIndex);
+            const std::size_t count = chunk.archetype ? chunk.count : 0;
+            _bvh.updateChunk(chunkIndex, count > 0 ? _entities.read<component::WorldTransform>(chunk) : nullptr, count, _boundingRadius);
+        }
+
+        _bvh.commit();
+        _bvhVersion = getVersion();
     }
 
-    const std::vector<glm::vec3>& Scene::getPositions() const noexcept {
-        return _trianglePositions;
+    Entity Scene::getInstanceEntity(uint32_t instance) const noexcept {
+        const ArchetypeChunk& chunk = _entities.getChunk(instance / constants::config::SCENE_CHUNK_CAPACITY);
+        return _entities.getEntity(chunk, instance % constants::config::SCENE_CHUNK_CAPACITY);
     }
 }
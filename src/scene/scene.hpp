@@ -1,19 +1,73 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 #include <glm.hpp>
+#include <gtc/quaternion.hpp>
+
+#include "instance_bvh.hpp"
+#include "entity_store.hpp"
+#include "frustum.hpp"
 
 namespace tv {
+    // objects are entities with local position/rotation/scale lanes, a world matrix and a hierarchy node;
+    // archetypes are grouped by depth, so one pass over the chunks resolves parents before children
     class Scene {
     public:
         Scene() noexcept;
+        explicit Scene(std::size_t triangleCount) noexcept;
 
         ~Scene() = default;
 
-        const std::vector<glm::vec3>& getPositions() const noexcept;
+        Entity createObject(const glm::vec3& position, Entity parent = nullEntity) noexcept;
+        // children have to be destroyed first
+        void destroyObject(Entity entity) noexcept;
+        bool alive(Entity entity) const noexcept;
+        std::size_t getObjectCount() const noexcept;
+        Entity getParent(Entity entity) const noexcept;
+        glm::vec3 getPosition(Entity entity) const noexcept;
+        void setPosition(Entity entity, const glm::vec3& position) noexcept;
+        void setRotation(Entity entity, const glm::quat& rotation) noexcept;
+        void setScale(Entity entity, const glm::vec3& scale) noexcept;
+
+        // recomputes world matrices of chunks whose local transforms or parents changed,
+        // chunks of the same depth are updated as parallel jobs
+        void updateWorldTransforms() noexcept;
+        const glm::mat4& getWorldMatrix(Entity entity) const noexcept;
+
+        // every chunk owns SCENE_CHUNK_CAPACITY instances at index * capacity, rows it does not use are zero matrices
+        std::size_t getInstanceCount() const noexcept;
+        std::size_t getChunkCount() const noexcept;
+        bool chunkChangedSince(std::size_t chunkIndex, uint64_t version) const noexcept;
+        void copyWorldMatrices(std::size_t first, std::size_t last, glm::mat4* out) const noexcept;
+        uint64_t getVersion() const noexcept;
+
+        // BVH queries over world bounds; the tree is refitted or rebuilt on first use after a change
+        void cull(const Frustum& frustum, std::vector<uint32_t>& visibleInstances) noexcept;
+        std::optional<Entity> pick(const glm::vec3& origin, const glm::vec3& direction) noexcept;
+        void pickPoint(const glm::vec3& point, std::vector<Entity>& entities) noexcept;
+
+        const glm::mat4& getViewProjection() const noexcept;
+        float getBoundingRadius() const noexcept;
 
     private:
-        std::vector<glm::vec3> _trianglePositions;
+        void updateChunkTransforms(ArchetypeChunk& chunk, uint64_t since) noexcept;
+        void updateBvh() noexcept;
+        Entity getInstanceEntity(uint32_t instance) const noexcept;
+
+        EntityStore _entities;
+        ComponentMask _objectMask;
+        // store version when world matrices were last brought up to date
+        uint64_t _updatedVersion;
+        // object chunks in depth order, gathered per update
+        std::vector<ArchetypeChunk*> _updateChunks;
+        InstanceBvh _bvh;
+        // store version the BVH bounds were taken at
+        uint64_t _bvhVersion;
+        glm::mat4 _viewProjection;
+        float _boundingRadius;
     };
 }
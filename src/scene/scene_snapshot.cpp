@@ -0,0 +1,86 @@
+#include "scene_snapshot.hpp"
+
+#include "scene.hpp"
+#include "transform_kernel.hpp"
+#include "../jobs/job_system.hpp"
+#include "../utility/config.hpp"
+
+namespace tv {
+    SceneSnapshot::SceneSnapshot() noexcept
+        : _source{ nullptr },
+          _version{ 0 },
+          _viewProjection{ 1.0f },
+          _boundingRadius{ 0.0f }
+    {}
+
+    void SceneSnapshot::extract(const Scene& scene) noexcept {
+        constexpr std::size_t capacity = constants::config::SCENE_CHUNK_CAPACITY;
+        const bool full = _source != &scene;
+        const uint64_t version = scene.getVersion();
+        if (!full && version == _version)
+            return;
+
+        const bool resized = _bvh.resize(scene.getInstanceCount());
+        _worlds.resize(scene.getInstanceCount());
+        _chunkVersions.resize(scene.getChunkCount(), 0);
+
+        _changedChunks.clear();
+        for (std::size_t chunkIndex = 0; chunkIndex < scene.getChunkCount(); ++chunkIndex) {
+            if (full || resized || scene.chunkChangedSince(chunkIndex, _version))
+                _changedChunks.push_back(chunkIndex);
+        }
+
+        _source = &scene;
+        _version = version;
+        _viewProjection = scene.getViewProjection();
+        _boundingRadius = scene.getBoundingRadius();
+
+        JobSystem::instance().parallelFor(_changedChunks.size(), constants::config::SCENE_EXTRACT_JOB_CHUNKS, [this, &scene, version](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                const std::size_t chunkIndex = _changedChunks[i];
+                glm::mat4* worlds = _worlds.data() + chunkIndex * capacity;
+                scene.copyWorldMatrices(chunkIndex * capacity, (chunkIndex + 1) * capacity, worlds);
+                _bvh.updateChunk(chunkIndex, worlds, capacity, _boundingRadius);
+                _chunkVersions[chunkIndex] = version;
+            }
+        });
+
+        _bvh.commit();
+    }
+
+    const Scene* SceneSnapshot::getSource() const noexcept {
+        return _source;
+    }
+
+    std::size_t SceneSnapshot::getInstanceCount() const noexcept {
+        return _worlds.size();
+    }
+
+    std::size_t SceneSnapshot::getChunkCount() const noexcept {
+        return _chunkVersions.size();
+    }
+
+    bool SceneSnapshot::chunkChangedSince(std::size_t chunkIndex, uint64_t version) const noexcept {
+        return _chunkVersions[chunkIndex] > version;
+    }
+
+    void SceneSnapshot::copyWorldMatrices(std::size_t first, std::size_t last, glm::mat4* out) const noexcept {
+        streamModelMatrices(_worlds.data() + first, last - first, out);
+    }
+
+    uint64_t SceneSnapshot::getVersion() const noexcept {
+        return _version;
+    }
+
+    void SceneSnapshot::cull(const Frustum& frustum, std::vector<uint32_t>& visibleInstances) const noexcept {
+        _bvh.getBvh().cull(frustum, visibleInstances);
+    }
+
+    const glm::mat4& SceneSnapshot::getViewProjection() const noexcept {
+        return _viewProjection;
+    }
+
+    float SceneSnapshot::getBoundingRadius() const noexcept {
+        return _boundingRadius;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "frustum.hpp"
+#include "instance_bvh.hpp"
+#include "../utility/types.hpp"
+
+namespace tv {
+    class Scene;
+
+    // what the renderer reads of a scene, copied out so the scene can be updated while a frame records.
+    // Only chunks changed since the snapshot's previous extract are copied; versions are the source scene's,
+    // so renderer state tracked against one snapshot stays valid for another of the same scene
+    class SceneSnapshot {
+    public:
+        TV_NCM(SceneSnapshot)
+
+        SceneSnapshot() noexcept;
+
+        ~SceneSnapshot() = default;
+
+        // the scene's world transforms have to be up to date
+        void extract(const Scene& scene) noexcept;
+
+        const Scene* getSource() const noexcept;
+        std::size_t getInstanceCount() const noexcept;
+        std::size_t getChunkCount() const noexcept;
+        bool chunkChangedSince(std::size_t chunkIndex, uint64_t version) const noexcept;
+        void copyWorldMatrices(std::size_t first, std::size_t last, glm::mat4* out) const noexcept;
+        uint64_t getVersion() const noexcept;
+        void cull(const Frustum& frustum, std::vector<uint32_t>& visibleInstances) const noexcept;
+        const glm::mat4& getViewProjection() const noexcept;
+        float getBoundingRadius() const noexcept;
+
+    private:
+        const Scene* _source;
+        uint64_t _version;
+        // instance slots of every chunk, unused rows are zero matrices as in the scene's instance layout
+        std::vector<glm::mat4> _worlds;
+        // scene version of the extract that last copied each chunk
+        std::vector<uint64_t> _chunkVersions;
+        std::vector<std::size_t> _changedChunks;
+        InstanceBvh _bvh;
+        glm::mat4 _viewProjection;
+        float _boundingRadius;
+    };
+}
@@ -0,0 +1,52 @@
+#include "scene_updater.hpp"
+
+namespace tv {
+    SceneUpdater::SceneUpdater(Scene* scene) noexcept
+        : _scene{ scene },
+          _snapshot{ nullptr },
+          _thread{ [this](std::stop_token stopToken) { threadLoop(stopToken); } }
+    {}
+
+    SceneUpdater::~SceneUpdater() {
+        _thread.request_stop();
+        _stepChanged.notify_all();
+
+        // join before the mutex and condition variable go away
+        _thread.join();
+    }
+
+    void SceneUpdater::begin(SceneSnapshot* snapshot) noexcept {
+        {
+            std::scoped_lock lock{ _mutex };
+            _snapshot = snapshot;
+        }
+        _stepChanged.notify_all();
+    }
+
+    void SceneUpdater::end() noexcept {
+        std::unique_lock lock{ _mutex };
+        _stepChanged.wait(lock, [this] { return _snapshot == nullptr; });
+    }
+
+    void SceneUpdater::threadLoop(std::stop_token stopToken) noexcept {
+        while (true) {
+            SceneSnapshot* snapshot = nullptr;
+            {
+                std::unique_lock lock{ _mutex };
+                if (!_stepChanged.wait(lock, stopToken, [this] { return _snapshot != nullptr; }))
+                    return;
+
+                snapshot = _snapshot;
+            }
+
+            _scene->updateWorldTransforms();
+            snapshot->extract(*_scene);
+
+            {
+                std::scoped_lock lock{ _mutex };
+                _snapshot = nullptr;
+            }
+            _stepChanged.notify_all();
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "scene.hpp"
+#include "scene_snapshot.hpp"
+#include "../utility/types.hpp"
+
+namespace tv {
+    // runs scene update steps on a thread of its own, so a step overlaps the frame the render thread records;
+    // the scene must not be touched elsewhere between begin and end
+    class SceneUpdater {
+    public:
+        TV_NCM(SceneUpdater)
+
+        explicit SceneUpdater(Scene* scene) noexcept;
+
+        ~SceneUpdater();
+
+        // brings the world transforms up to date and extracts them into the snapshot
+        void begin(SceneSnapshot* snapshot) noexcept;
+        // waits for the step started by begin
+        void end() noexcept;
+
+    private:
+        void threadLoop(std::stop_token stopToken) noexcept;
+
+        Scene* _scene;
+        std::mutex _mutex;
+        std::condition_variable_any _stepChanged;
+        // target of the running step, null when idle
+        SceneSnapshot* _snapshot;
+        // last, so the thread starts once everything it uses is initialized
+        std::jthread _thread;
+    };
+}
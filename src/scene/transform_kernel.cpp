@@ -0,0 +1,281 @@
+#include "transform_kernel.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <vector>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define TV_TRANSFORM_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TV_TRANSFORM_SSE2 1
+#endif
+
+#include "../logger.hpp"
+#include "../utility/config.hpp"
+#include "../utility/messages.hpp"
+
+namespace tv {
+    static_assert(sizeof(glm::mat4) == 16 * sizeof(float));
+
+    namespace {
+#if defined(TV_TRANSFORM_AVX2)
+        // 8 objects per iteration: the 16 matrix elements are computed lane-wise, then
+        // two 8x8 transposes turn them into 8 consecutive column-major matrices
+        void transpose8(__m256 r[8]) noexcept {
+            const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+            const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+            const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+            const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+            const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+            const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+            const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+            const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+            const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+            const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+            const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+            r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+            r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+            r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+            r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+            r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+            r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+            r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+            r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+        }
+
+        std::size_t buildWide(const TransformArrays& t, std::size_t first, std::size_t last, float* dst) noexcept {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 two = _mm256_set1_ps(2.0f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            std::size_t i = first;
+            for (; i + 8 <= last; i += 8) {
+                const __m256 x = _mm256_loadu_ps(t.rotationX + i);
+                const __m256 y = _mm256_loadu_ps(t.rotationY + i);
+                const __m256 z = _mm256_loadu_ps(t.rotationZ + i);
+                const __m256 w = _mm256_loadu_ps(t.rotationW + i);
+                const __m256 sx = _mm256_loadu_ps(t.scaleX + i);
+                const __m256 sy = _mm256_loadu_ps(t.scaleY + i);
+                const __m256 sz = _mm256_loadu_ps(t.scaleZ + i);
+
+                const __m256 x2 = _mm256_mul_ps(x, two);
+                const __m256 y2 = _mm256_mul_ps(y, two);
+                const __m256 z2 = _mm256_mul_ps(z, two);
+                const __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+                const __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+                const __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+
+                __m256 low[8] = {
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+                    _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+                    _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx),
+                    zero,
+                    _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+                    _mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+                    zero
+                };
+                __m256 high[8] = {
+                    _mm256_mul_ps(_mm256_add_ps(xz, wy), sz),
+                    _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+                    zero,
+                    _mm256_loadu_ps(t.positionX + i),
+                    _mm256_loadu_ps(t.positionY + i),
+                    _mm256_loadu_ps(t.positionZ + i),
+                    one
+                };
+
+                transpose8(low);
+                transpose8(high);
+
+                for (int k = 0; k < 8; ++k) {
+                    _mm256_storeu_ps(dst, low[k]);
+                    _mm256_storeu_ps(dst + 8, high[k]);
+                    dst += 16;
+                }
+            }
+
+            return i;
+        }
+
+        void streamMatrix(float* dst, const float* src) noexcept {
+            _mm256_stream_ps(dst, _mm256_loadu_ps(src));
+            _mm256_stream_ps(dst + 8, _mm256_loadu_ps(src + 8));
+        }
+
+        constexpr std::uintptr_t streamAlignment = 32;
+#elif defined(TV_TRANSFORM_SSE2)
+        // 4 objects per iteration, four 4x4 transposes per batch
+        std::size_t buildWide(const TransformArrays& t, std::size_t first, std::size_t last, float* dst) noexcept {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            std::size_t i = first;
+            for (; i + 4 <= last; i += 4) {
+                const __m128 x = _mm_loadu_ps(t.rotationX + i);
+                const __m128 y = _mm_loadu_ps(t.rotationY + i);
+                const __m128 z = _mm_loadu_ps(t.rotationZ + i);
+                const __m128 w = _mm_loadu_ps(t.rotationW + i);
+                const __m128 sx = _mm_loadu_ps(t.scaleX + i);
+                const __m128 sy = _mm_loadu_ps(t.scaleY + i);
+                const __m128 sz = _mm_loadu_ps(t.scaleZ + i);
+
+                const __m128 x2 = _mm_mul_ps(x, two);
+                const __m128 y2 = _mm_mul_ps(y, two);
+                const __m128 z2 = _mm_mul_ps(z, two);
+                const __m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+                const __m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+                const __m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+
+                __m128 c0 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx);
+                __m128 c1 = _mm_mul_ps(_mm_add_ps(xy, wz), sx);
+                __m128 c2 = _mm_mul_ps(_mm_sub_ps(xz, wy), sx);
+                __m128 c3 = zero;
+                __m128 c4 = _mm_mul_ps(_mm_sub_ps(xy, wz), sy);
+                __m128 c5 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy);
+                __m128 c6 = _mm_mul_ps(_mm_add_ps(yz, wx), sy);
+                __m128 c7 = zero;
+                __m128 c8 = _mm_mul_ps(_mm_add_ps(xz, wy), sz);
+                __m128 c9 = _mm_mul_ps(_mm_sub_ps(yz, wx), sz);
+                __m128 c10 = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz);
+                __m128 c11 = zero;
+                __m128 c12 = _mm_loadu_ps(t.positionX + i);
+                __m128 c13 = _mm_loadu_ps(t.positionY + i);
+                __m128 c14 = _mm_loadu_ps(t.positionZ + i);
+                __m128 c15 = one;
+
+                _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+                _MM_TRANSPOSE4_PS(c4, c5, c6, c7);
+                _MM_TRANSPOSE4_PS(c8, c9, c10, c11);
+                _MM_TRANSPOSE4_PS(c12, c13, c14, c15);
+
+                const __m128 columns[16] = { c0, c4, c8, c12, c1, c5, c9, c13, c2, c6, c10, c14, c3, c7, c11, c15 };
+                for (int k = 0; k < 16; ++k) {
+                    _mm_storeu_ps(dst, columns[k]);
+                    dst += 4;
+                }
+            }
+
+            return i;
+        }
+
+        void streamMatrix(float* dst, const float* src) noexcept {
+            for (int k = 0; k < 16; k += 4)
+                _mm_stream_ps(dst + k, _mm_loadu_ps(src + k));
+        }
+
+        constexpr std::uintptr_t streamAlignment = 16;
+#endif
+    }
+
+    void buildModelMatrices(const TransformArrays& transforms, std::size_t first, std::size_t last, glm::mat4* out) noexcept {
+#if defined(TV_TRANSFORM_AVX2) || defined(TV_TRANSFORM_SSE2)
+        const std::size_t tail = buildWide(transforms, first, last, reinterpret_cast<float*>(out));
+        buildModelMatricesScalar(transforms, tail, last, out + (tail - first));
+#else
+        buildModelMatricesScalar(transforms, first, last, out);
+#endif
+    }
+
+    void buildModelMatricesScalar(const TransformArrays& t, std::size_t first, std::size_t last, glm::mat4* out) noexcept {
+        for (std::size_t i = first; i < last; ++i) {
+            const float x = t.rotationX[i];
+            const float y = t.rotationY[i];
+            const float z = t.rotationZ[i];
+            const float w = t.rotationW[i];
+
+            const float xx = 2.0f * x * x, yy = 2.0f * y * y, zz = 2.0f * z * z;
+            const float xy = 2.0f * x * y, xz = 2.0f * x * z, yz = 2.0f * y * z;
+            const float wx = 2.0f * w * x, wy = 2.0f * w * y, wz = 2.0f * w * z;
+
+            glm::mat4& m = *out++;
+            m[0] = glm::vec4((1.0f - yy - zz) * t.scaleX[i], (xy + wz) * t.scaleX[i], (xz - wy) * t.scaleX[i], 0.0f);
+            m[1] = glm::vec4((xy - wz) * t.scaleY[i], (1.0f - xx - zz) * t.scaleY[i], (yz + wx) * t.scaleY[i], 0.0f);
+            m[2] = glm::vec4((xz + wy) * t.scaleZ[i], (yz - wx) * t.scaleZ[i], (1.0f - xx - yy) * t.scaleZ[i], 0.0f);
+            m[3] = glm::vec4(t.positionX[i], t.positionY[i], t.positionZ[i], 1.0f);
+        }
+    }
+
+    void streamModelMatrices(const glm::mat4* matrices, std::size_t count, glm::mat4* out) noexcept {
+#if defined(TV_TRANSFORM_AVX2) || defined(TV_TRANSFORM_SSE2)
+        // non-temporal stores keep a full-scene copy from evicting the caches and suit write-combined memory
+        if (reinterpret_cast<std::uintptr_t>(out) % streamAlignment == 0) {
+            const float* src = reinterpret_cast<const float*>(matrices);
+            float* dst = reinterpret_cast<float*>(out);
+            for (std::size_t i = 0; i < count; ++i)
+                streamMatrix(dst + i * 16, src + i * 16);
+            _mm_sfence();
+            return;
+        }
+#endif
+        std::memcpy(out, matrices, count * sizeof(glm::mat4));
+    }
+
+    void clearModelMatrices(std::size_t count, glm::mat4* out) noexcept {
+        std::memset(out, 0, count * sizeof(glm::mat4));
+    }
+
+    const char* transformKernelName() noexcept {
+#if defined(TV_TRANSFORM_AVX2)
+        return "avx2";
+#elif defined(TV_TRANSFORM_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+
+    void benchmarkModelMatrices() noexcept {
+        constexpr std::size_t count = constants::config::TRANSFORM_BENCHMARK_MATRIX_COUNT;
+        constexpr std::size_t iterations = constants::config::TRANSFORM_BENCHMARK_ITERATIONS;
+
+        // identity rotations and unit scales, the kernels do the same work whatever the values
+        std::vector<float> zeros(count, 0.0f);
+        std::vector<float> ones(count, 1.0f);
+        const TransformArrays transforms{
+            zeros.data(), zeros.data(), zeros.data(),
+            zeros.data(), zeros.data(), zeros.data(), ones.data(),
+            ones.data(), ones.data(), ones.data()
+        };
+        std::vector<glm::mat4> matrices(count);
+
+        const auto measure = [&](auto build) {
+            // the first pass faults the output in
+            build(transforms, 0, count, matrices.data());
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < iterations; ++i)
+                build(transforms, 0, count, matrices.data());
+
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count() / iterations;
+        };
+
+        const double kernel = measure(buildModelMatrices);
+        const double scalar = measure(buildModelMatricesScalar);
+        // every matrix is 64 bytes of output, the bandwidth shows when the stores rather than the math are the limit
+        const double gigabytesPerSecond = static_cast<double>(count * sizeof(glm::mat4)) / (kernel * 1e6);
+        Logger::instance().log(std::format(
+            "{}: {} matrices, {}: {:.3f} ms ({:.1f} GB/s written), scalar: {:.3f} ms, {:.2f}x\n",
+            constants::messages::TRANSFORM_BENCHMARK,
+            count,
+            transformKernelName(),
+            kernel,
+            gigabytesPerSecond,
+            scalar,
+            scalar / kernel
+        ));
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm.hpp>
+
+namespace tv {
+    // structure-of-arrays view over object transforms, rotations are unit quaternions
+    struct TransformArrays {
+        const float* positionX;
+        const float* positionY;
+        const float* positionZ;
+        const float* rotationX;
+        const float* rotationY;
+        const float* rotationZ;
+        const float* rotationW;
+        const float* scaleX;
+        const float* scaleY;
+        const float* scaleZ;
+    };
+
+    // writes translate * rotate * scale for objects [first, last) to out[0, last - first)
+    void buildModelMatrices(const TransformArrays& transforms, std::size_t first, std::size_t last, glm::mat4* out) noexcept;
+    // the portable path, the SIMD kernels use it for the objects left over after their last full batch
+    void buildModelMatricesScalar(const TransformArrays& transforms, std::size_t first, std::size_t last, glm::mat4* out) noexcept;
+    // sequential copy meant for write-combined mapped memory
+    void streamModelMatrices(const glm::mat4* matrices, std::size_t count, glm::mat4* out) noexcept;
+    void clearModelMatrices(std::size_t count, glm::mat4* out) noexcept;
+    [[nodiscard]] const char* transformKernelName() noexcept;
+    // logs the kernel against the scalar path over a large batch
+    void benchmarkModelMatrices() noexcept;
+}
@@ -0,0 +1,346 @@
+#include "async_file_reader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fstream>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #define TV_IO_URING 1
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#else
+    #define TV_IO_URING 0
+#endif
+
+#include "../logger.hpp"
+#include "../utility/config.hpp"
+#include "../utility/messages.hpp"
+
+namespace tv::service {
+#if(TV_IO_URING)
+    // raw rings rather than liburing, the handful of calls needed does not justify the dependency
+    struct AsyncFileReader::Ring {
+        int fd;
+        void* queueMemory;
+        std::size_t queueSize;
+        void* completionMemory;
+        std::size_t completionSize;
+        io_uring_sqe* entries;
+        std::size_t entriesSize;
+        uint32_t* submissionHead;
+        uint32_t* submissionTail;
+        uint32_t submissionMask;
+        uint32_t* submissionArray;
+        uint32_t submissionCapacity;
+        uint32_t* completionHead;
+        uint32_t* completionTail;
+        uint32_t completionMask;
+        io_uring_cqe* completions;
+        // entries written but not yet passed to the kernel, and reads the kernel still owns
+        uint32_t unsubmitted;
+        uint32_t inFlight;
+    };
+
+    namespace {
+        int enterRing(int fd, uint32_t submitCount, uint32_t minComplete, uint32_t flags) noexcept {
+            return static_cast<int>(syscall(__NR_io_uring_enter, fd, submitCount, minComplete, flags, nullptr, 0));
+        }
+    }
+#else
+    struct AsyncFileReader::Ring {};
+#endif
+
+    AsyncFileReader::AsyncFileReader(bool useIoUring) noexcept {
+        if (!useIoUring || !setupRing())
+            _ring.reset();
+
+#if(TV_DEBUG_MODE)
+        if (_ring)
+            Logger::instance().log(std::format("{}\n", constants::messages::FILE_IO_URING_ENABLED));
+#endif
+    }
+
+    AsyncFileReader::~AsyncFileReader() {
+        wait();
+        destroyRing();
+    }
+
+    void AsyncFileReader::queue(const std::string& filePath, std::span<char> destination, uint64_t offset, ReadCallback callback) noexcept {
+        auto request = std::make_unique<Request>(Request{ this, filePath, destination, offset, std::move(callback), -1, 0, false, _requests.size() });
+        _queued.push_back(request.get());
+        _requests.push_back(std::move(request));
+    }
+
+    void AsyncFileReader::submit() noexcept {
+        if (_ring) {
+            submitRing();
+            return;
+        }
+
+        while (!_queued.empty()) {
+            runJob(*_queued.front());
+            _queued.pop_front();
+        }
+    }
+
+    std::size_t AsyncFileReader::poll() noexcept {
+        if (_ring) {
+            reapRing(false);
+            submitRing();
+        }
+
+        return drainCompleted();
+    }
+
+    void AsyncFileReader::wait() noexcept {
+        submit();
+        while (!_requests.empty()) {
+#if(TV_IO_URING)
+            if (_ring && _ring->inFlight > 0) {
+                reapRing(true);
+                submitRing();
+            }
+#endif
+            if (!_jobs.done())
+                JobSystem::instance().wait(_jobs);
+
+            drainCompleted();
+        }
+    }
+
+    bool AsyncFileReader::usesIoUring() const noexcept {
+        return _ring != nullptr;
+    }
+
+    std::size_t AsyncFileReader::getPendingCount() const noexcept {
+        return _requests.size();
+    }
+
+    bool AsyncFileReader::setupRing() noexcept {
+#if(TV_IO_URING)
+        io_uring_params params{};
+        const int fd = static_cast<int>(syscall(__NR_io_uring_setup, constants::config::FILE_IO_QUEUE_DEPTH, &params));
+        // old kernels and sandboxes that filter the syscall take the job path
+        if (fd < 0)
+            return false;
+
+        _ring = std::make_unique<Ring>();
+        Ring& ring = *_ring;
+        ring.fd = fd;
+        ring.queueSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        ring.completionSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        ring.entriesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        const bool singleMapping = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMapping)
+            ring.queueSize = ring.completionSize = std::max(ring.queueSize, ring.completionSize);
+
+        ring.queueMemory = mmap(nullptr, ring.queueSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        ring.completionMemory = singleMapping
+            ? ring.queueMemory
+            : mmap(nullptr, ring.completionSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        void* entries = mmap(nullptr, ring.entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        ring.entries = entries == MAP_FAILED ? nullptr : static_cast<io_uring_sqe*>(entries);
+        if (ring.queueMemory == MAP_FAILED || ring.completionMemory == MAP_FAILED || !ring.entries) {
+            destroyRing();
+            return false;
+        }
+
+        auto* queue = static_cast<char*>(ring.queueMemory);
+        ring.submissionHead = reinterpret_cast<uint32_t*>(queue + params.sq_off.head);
+        ring.submissionTail = reinterpret_cast<uint32_t*>(queue + params.sq_off.tail);
+        ring.submissionMask = *reinterpret_cast<uint32_t*>(queue + params.sq_off.ring_mask);
+        ring.submissionArray = reinterpret_cast<uint32_t*>(queue + params.sq_off.array);
+        ring.submissionCapacity = params.sq_entries;
+
+        auto* completion = static_cast<char*>(ring.completionMemory);
+        ring.completionHead = reinterpret_cast<uint32_t*>(completion + params.cq_off.head);
+        ring.completionTail = reinterpret_cast<uint32_t*>(completion + params.cq_off.tail);
+        ring.completionMask = *reinterpret_cast<uint32_t*>(completion + params.cq_off.ring_mask);
+        ring.completions = reinterpret_cast<io_uring_cqe*>(completion + params.cq_off.cqes);
+
+        ring.unsubmitted = 0;
+        ring.inFlight = 0;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void AsyncFileReader::destroyRing() noexcept {
+#if(TV_IO_URING)
+        if (!_ring)
+            return;
+
+        Ring& ring = *_ring;
+        if (ring.entries)
+            munmap(ring.entries, ring.entriesSize);
+        if (ring.completionMemory != MAP_FAILED && ring.completionMemory != ring.queueMemory)
+            munmap(ring.completionMemory, ring.completionSize);
+        if (ring.queueMemory != MAP_FAILED)
+            munmap(ring.queueMemory, ring.queueSize);
+        close(ring.fd);
+#endif
+        _ring.reset();
+    }
+
+    void AsyncFileReader::submitRing() noexcept {
+#if(TV_IO_URING)
+        while (!_queued.empty()) {
+            Request& request = *_queued.front();
+            if (request.file < 0) {
+                request.file = open(request.filePath.c_str(), O_RDONLY | O_CLOEXEC);
+                if (request.file < 0) {
+                    _queued.pop_front();
+                    markCompleted(request);
+                    continue;
+                }
+            }
+
+            if (!pushRead(request))
+                break;
+            _queued.pop_front();
+        }
+
+        // one system call for the whole batch
+        Ring& ring = *_ring;
+        while (ring.unsubmitted > 0) {
+            const int submitted = enterRing(ring.fd, ring.unsubmitted, 0, 0);
+            if (submitted <= 0) {
+                // interrupted or out of kernel resources, retried on the next submit or reap
+                if (submitted < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                    Logger::instance().err(std::format("{}: {}\n", constants::messages::FILE_IO_URING_SUBMIT_FAILED, std::strerror(errno)));
+                break;
+            }
+
+            ring.unsubmitted -= static_cast<uint32_t>(submitted);
+        }
+#endif
+    }
+
+    bool AsyncFileReader::pushRead([[maybe_unused]] Request& request) noexcept {
+#if(TV_IO_URING)
+        Ring& ring = *_ring;
+        // completions have twice the room of submissions, so capping at the submission size never overflows them
+        if (ring.inFlight == ring.submissionCapacity)
+            return false;
+
+        const uint32_t tail = *ring.submissionTail;
+        const uint32_t index = tail & ring.submissionMask;
+        io_uring_sqe& entry = ring.entries[index];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_READ;
+        entry.fd = request.file;
+        entry.addr = reinterpret_cast<uint64_t>(request.destination.data() + request.bytesRead);
+        entry.len = static_cast<uint32_t>(std::min<std::size_t>(request.destination.size() - request.bytesRead, constants::config::FILE_IO_MAX_READ_SIZE));
+        entry.off = request.offset + request.bytesRead;
+        entry.user_data = reinterpret_cast<uint64_t>(&request);
+
+        ring.submissionArray[index] = index;
+        std::atomic_ref<uint32_t>{ *ring.submissionTail }.store(tail + 1, std::memory_order_release);
+        ++ring.unsubmitted;
+        ++ring.inFlight;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void AsyncFileReader::reapRing([[maybe_unused]] bool block) noexcept {
+#if(TV_IO_URING)
+        Ring& ring = *_ring;
+        uint32_t head = *ring.completionHead;
+        if (block && head == std::atomic_ref<uint32_t>{ *ring.completionTail }.load(std::memory_order_acquire)) {
+            // passes on whatever is still unsubmitted as well, so that has to be accounted for
+            const int submitted = enterRing(ring.fd, ring.unsubmitted, 1, IORING_ENTER_GETEVENTS);
+            if (submitted > 0)
+                ring.unsubmitted -= static_cast<uint32_t>(submitted);
+        }
+
+        const uint32_t tail = std::atomic_ref<uint32_t>{ *ring.completionTail }.load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& completion = ring.completions[head & ring.completionMask];
+            Request& request = *reinterpret_cast<Request*>(completion.user_data);
+            --ring.inFlight;
+
+            if (completion.res == -EINVAL || completion.res == -EOPNOTSUPP) {
+                // kernels before 5.6 know the ring but not plain reads
+                runJob(request);
+            } else if (completion.res < 0) {
+                markCompleted(request);
+            } else if (completion.res > 0 && request.bytesRead + static_cast<std::size_t>(completion.res) < request.destination.size()) {
+                // short read, the rest goes first on the next submit
+                request.bytesRead += static_cast<std::size_t>(completion.res);
+                _queued.push_front(&request);
+            } else {
+                request.bytesRead += static_cast<std::size_t>(completion.res);
+                request.succeeded = true;
+                markCompleted(request);
+            }
+        }
+
+        std::atomic_ref<uint32_t>{ *ring.completionHead }.store(head, std::memory_order_release);
+#endif
+    }
+
+    void AsyncFileReader::runJob(Request& request) noexcept {
+        // blocking reads, so a worker is tied up for the duration; fine for loads, not for frame work
+        JobSystem::instance().run(Job{
+            [](void* data, std::size_t, std::size_t) {
+                Request& request = *static_cast<Request*>(data);
+                std::ifstream file{ request.filePath, std::ios::binary };
+                if (file.is_open()) {
+                    file.seekg(static_cast<std::streamoff>(request.offset + request.bytesRead));
+                    file.read(request.destination.data() + request.bytesRead, static_cast<std::streamsize>(request.destination.size() - request.bytesRead));
+                    request.bytesRead += static_cast<std::size_t>(file.gcount());
+                    request.succeeded = !file.bad();
+                }
+
+                request.reader->markCompleted(request);
+            },
+            &request,
+            0,
+            0,
+            nullptr
+        }, _jobs);
+    }
+
+    void AsyncFileReader::markCompleted(Request& request) noexcept {
+        std::scoped_lock lock{ _completedMutex };
+        _completed.push_back(&request);
+    }
+
+    std::size_t AsyncFileReader::drainCompleted() noexcept {
+        std::vector<Request*> completed;
+        {
+            std::scoped_lock lock{ _completedMutex };
+            completed.swap(_completed);
+        }
+
+        for (Request* request : completed)
+            complete(*request);
+
+        return completed.size();
+    }
+
+    void AsyncFileReader::complete(Request& request) noexcept {
+#if(TV_IO_URING)
+        if (request.file >= 0)
+            close(request.file);
+#endif
+        if (request.callback)
+            request.callback(request.bytesRead, request.succeeded);
+
+        // swap-remove, the moved request keeps its address
+        const std::size_t slot = request.slot;
+        std::swap(_requests[slot], _requests.back());
+        _requests[slot]->slot = slot;
+        _requests.pop_back();
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../jobs/job_system.hpp"
+#include "../utility/types.hpp"
+
+namespace tv::service {
+    // bytes read, short at the end of the file; false when the file could not be opened or read
+    using ReadCallback = std::function<void(std::size_t bytesRead, bool succeeded)>;
+
+    // reads many files into caller-owned buffers, e.g. mapped staging memory. Queued reads are submitted
+    // in batches through io_uring where the kernel allows it, and run as blocking job system jobs otherwise.
+    // Callbacks run on the thread calling poll or wait, buffers must stay alive until then
+    class AsyncFileReader {
+    public:
+        TV_NCM(AsyncFileReader)
+
+        // without io_uring every read takes the job path
+        explicit AsyncFileReader(bool useIoUring = true) noexcept;
+
+        ~AsyncFileReader();
+
+        void queue(const std::string& filePath, std::span<char> destination, uint64_t offset, ReadCallback callback) noexcept;
+        // starts every queued read the ring has room for, the rest go once earlier reads complete
+        void submit() noexcept;
+        // runs callbacks of finished reads without blocking, returns how many ran
+        std::size_t poll() noexcept;
+        // submits and completes everything queued
+        void wait() noexcept;
+        [[nodiscard]] bool usesIoUring() const noexcept;
+        [[nodiscard]] std::size_t getPendingCount() const noexcept;
+
+    private:
+        struct Request {
+            AsyncFileReader* reader;
+            std::string filePath;
+            std::span<char> destination;
+            uint64_t offset;
+            ReadCallback callback;
+            int file;
+            // progress, a read may come back short and is resubmitted for the rest
+            std::size_t bytesRead;
+            bool succeeded;
+            // position in _requests
+            std::size_t slot;
+        };
+
+        struct Ring;
+
+        [[nodiscard]] bool setupRing() noexcept;
+        void destroyRing() noexcept;
+        void submitRing() noexcept;
+        [[nodiscard]] bool pushRead(Request& request) noexcept;
+        void reapRing(bool block) noexcept;
+        void runJob(Request& request) noexcept;
+        void markCompleted(Request& request) noexcept;
+        std::size_t drainCompleted() noexcept;
+        void complete(Request& request) noexcept;
+
+        std::unique_ptr<Ring> _ring;
+        // every unfinished read, the kernel and jobs only hold raw pointers into these
+        std::vector<std::unique_ptr<Request>> _requests;
+        std::deque<Request*> _queued;
+        // finished reads waiting for their callback, filled by ring reaping and worker jobs
+        std::mutex _completedMutex;
+        std::vector<Request*> _completed;
+        JobCounter _jobs;
+    };
+}
@@ -1,13 +1,135 @@
 #include "file_service.hpp"
 
 #include <fstream>
+#include <filesystem>
+#include <system_error>
 #include <format>
 #include <cassert>
+#include <utility>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 #include "../logger.hpp"
 #include "../utility/messages.hpp"
 
 namespace tv::service {
+    namespace {
+        // returns the view of the whole file, null when the file is empty or cannot be mapped
+        void* mapFile(const std::string& filePath, std::size_t& size) noexcept {
+#if defined(_WIN32)
+            HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return nullptr;
+
+            LARGE_INTEGER fileSize{};
+            void* view = nullptr;
+            if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+                // the view keeps the mapping alive, both handles can go right away
+                HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping) {
+                    view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    CloseHandle(mapping);
+                }
+            }
+            CloseHandle(file);
+
+            size = view ? static_cast<std::size_t>(fileSize.QuadPart) : 0;
+            return view;
+#else
+            const int file = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (file < 0)
+                return nullptr;
+
+            struct stat status{};
+            void* view = nullptr;
+            if (fstat(file, &status) == 0 && status.st_size > 0) {
+                view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+                if (view == MAP_FAILED)
+                    view = nullptr;
+                else
+                    posix_madvise(view, static_cast<std::size_t>(status.st_size), POSIX_MADV_SEQUENTIAL);
+            }
+            // the mapping holds its own reference to the file
+            close(file);
+
+            size = view ? static_cast<std::size_t>(status.st_size) : 0;
+            return view;
+#endif
+        }
+
+        void unmapFile(void* view, [[maybe_unused]] std::size_t size) noexcept {
+#if defined(_WIN32)
+            UnmapViewOfFile(view);
+#else
+            munmap(view, size);
+#endif
+        }
+    }
+
+    MappedFile::MappedFile() noexcept
+        : _mapping{ nullptr },
+          _size{ 0 }
+    {}
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : _mapping{ std::exchange(other._mapping, nullptr) },
+          _size{ std::exchange(other._size, 0) },
+          _buffer{ std::move(other._buffer) }
+    {}
+
+    MappedFile::~MappedFile() {
+        release();
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            _mapping = std::exchange(other._mapping, nullptr);
+            _size = std::exchange(other._size, 0);
+            _buffer = std::move(other._buffer);
+        }
+
+        return *this;
+    }
+
+    const char* MappedFile::data() const noexcept {
+        return _mapping ? static_cast<const char*>(_mapping) : _buffer.data();
+    }
+
+    std::size_t MappedFile::size() const noexcept {
+        return _mapping ? _size : _buffer.size();
+    }
+
+    bool MappedFile::empty() const noexcept {
+        return size() == 0;
+    }
+
+    std::span<const char> MappedFile::getSpan() const noexcept {
+        return { data(), size() };
+    }
+
+    bool MappedFile::isMapped() const noexcept {
+        return _mapping != nullptr;
+    }
+
+    void MappedFile::release() noexcept {
+        if (_mapping)
+            unmapFile(_mapping, _size);
+
+        _mapping = nullptr;
+        _size = 0;
+        _buffer.clear();
+    }
+
     std::vector<char> FileService::read(const std::string& filePath) noexcept {
         std::ifstream file{ filePath, std::ios::ate | std::ios::binary };
         if (!file.is_open()) {
@@ -24,4 +146,71 @@ namespace tv::service {
         file.close();
         return buffer;
     }
+
+    MappedFile FileService::map(const std::string& filePath) noexcept {
+        MappedFile file{};
+        file._mapping = mapFile(filePath, file._size);
+        if (file._mapping)
+            return file;
+
+        // empty files and file systems without mapping support end up here
+#if(TV_DEBUG_MODE)
+        Logger::instance().log(std::format("{}: {}\n", constants::messages::FILE_MAP_FAILED, filePath));
+#endif
+        file._buffer = read(filePath);
+        return file;
+    }
+
+    bool FileService::writeAtomically(const std::string& filePath, const std::vector<char>& data) noexcept {
+        // readers see either the old file or the complete new one, never a partial write
+        const std::string tempPath = filePath + ".tmp";
+        {
+            std::ofstream file{ tempPath, std::ios::trunc | std::ios::binary };
+            if (!file.is_open()) {
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::FILE_WRITE_FAILED, tempPath));
+                return false;
+            }
+
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file.good()) {
+                Logger::instance().err(std::format("{}: {}\n", constants::messages::FILE_WRITE_FAILED, tempPath));
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, filePath, error);
+        if (error) {
+            Logger::instance().err(std::format("{}: {}\n", constants::messages::FILE_WRITE_FAILED, error.message()));
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+
+        return true;
+    }
+
+    const std::filesystem::path& FileService::getExecutableDirectory() noexcept {
+        static const std::filesystem::path directory = [] {
+            std::filesystem::path executable;
+            std::error_code error;
+#if defined(_WIN32)
+            // a full buffer means the path was truncated
+            std::wstring buffer(MAX_PATH, L'\0');
+            DWORD length = 0;
+            while ((length = GetModuleFileNameW(nullptr, buffer.data(), static_cast<DWORD>(buffer.size()))) == buffer.size())
+                buffer.resize(buffer.size() * 2);
+            buffer.resize(length);
+            executable = buffer;
+#else
+            executable = std::filesystem::read_symlink("/proc/self/exe", error);
+#endif
+            if (executable.has_parent_path())
+                return executable.parent_path();
+
+            Logger::instance().err(std::format("{}\n", constants::messages::FILE_EXECUTABLE_DIRECTORY_UNKNOWN));
+            return std::filesystem::current_path(error);
+        }();
+
+        return directory;
+    }
 }
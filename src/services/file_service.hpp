@@ -1,9 +1,43 @@
 #pragma once
 
+#include <cstddef>
+#include <filesystem>
+#include <span>
 #include <vector>
 #include <string>
 
 namespace tv::service {
+    // read-only view of a whole file, memory-mapped where the platform allows and read into
+    // an owned buffer otherwise; the mapping is released with the object.
+    // Either way the data is aligned well enough to hand to Vulkan as SPIR-V
+    class MappedFile {
+    public:
+        MappedFile() noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+
+        ~MappedFile();
+
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        [[nodiscard]] const char* data() const noexcept;
+        [[nodiscard]] std::size_t size() const noexcept;
+        [[nodiscard]] bool empty() const noexcept;
+        [[nodiscard]] std::span<const char> getSpan() const noexcept;
+        [[nodiscard]] bool isMapped() const noexcept;
+
+    private:
+        friend class FileService;
+
+        void release() noexcept;
+
+        // null when not mapped
+        void* _mapping;
+        std::size_t _size;
+        std::vector<char> _buffer;
+    };
+
     class FileService {
     public:
         FileService() = default;
@@ -11,5 +45,10 @@ namespace tv::service {
         ~FileService() = default;
 
         static std::vector<char> read(const std::string& filePath) noexcept;
+        // no copy for mapped files, the pages are read on first touch
+        static MappedFile map(const std::string& filePath) noexcept;
+        static bool writeAtomically(const std::string& filePath, const std::vector<char>& data) noexcept;
+        // resolved once, falls back to the working directory when the platform cannot tell
+        static const std::filesystem::path& getExecutableDirectory() noexcept;
     };
 }
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace tv::shader {
+    // SPIR-V the build compiled into the executable, looked up by the name of the file it was compiled to;
+    // empty for shaders that were not embedded
+    [[nodiscard]] std::span<const uint32_t> findEmbeddedShader(std::string_view fileName) noexcept;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <glm.hpp>
+
+namespace tv::shader::model {
+    struct Camera {
+        glm::mat4 viewProjection;
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm.hpp>
+
+namespace tv::shader::model {
+    struct Cull {
+        glm::vec4 planes[6];
+        uint32_t instanceCount;
+        float radius;
+    };
+
+    struct DrawCommand {
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t firstVertex;
+        uint32_t firstInstance;
+        uint32_t drawCount;
+    };
+}
@@ -0,0 +1,398 @@
+#include "reflection.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace tv::shader {
+    namespace {
+        constexpr uint32_t spirvMagic = 0x07230203;
+        constexpr std::size_t headerWords = 5;
+
+        // the subset of the SPIR-V grammar the interface is built from
+        enum Op : uint32_t {
+            opEntryPoint = 15,
+            opExecutionMode = 16,
+            opTypeInt = 21,
+            opTypeFloat = 22,
+            opTypeVector = 23,
+            opTypeMatrix = 24,
+            opTypeImage = 25,
+            opTypeSampler = 26,
+            opTypeSampledImage = 27,
+            opTypeArray = 28,
+            opTypeRuntimeArray = 29,
+            opTypeStruct = 30,
+            opTypePointer = 32,
+            opConstant = 43,
+            opVariable = 59,
+            opDecorate = 71,
+            opMemberDecorate = 72
+        };
+
+        enum Decoration : uint32_t {
+            decorationBufferBlock = 3,
+            decorationArrayStride = 6,
+            decorationMatrixStride = 7,
+            decorationLocation = 30,
+            decorationBinding = 33,
+            decorationDescriptorSet = 34,
+            decorationOffset = 35
+        };
+
+        enum StorageClass : uint32_t {
+            storageUniformConstant = 0,
+            storageInput = 1,
+            storageUniform = 2,
+            storagePushConstant = 9,
+            storageStorageBuffer = 12
+        };
+
+        enum ExecutionModel : uint32_t {
+            modelVertex = 0,
+            modelFragment = 4,
+            modelGLCompute = 5
+        };
+
+        constexpr uint32_t executionModeLocalSize = 17;
+        constexpr uint32_t imageDimBuffer = 5;
+
+        struct Type {
+            Op opcode;
+            // the words after the result id
+            std::vector<uint32_t> operands;
+        };
+
+        struct Member {
+            std::optional<uint32_t> offset;
+            std::optional<uint32_t> matrixStride;
+        };
+
+        struct Decorations {
+            std::optional<uint32_t> location;
+            std::optional<uint32_t> set;
+            std::optional<uint32_t> binding;
+            std::optional<uint32_t> arrayStride;
+            bool bufferBlock;
+            std::vector<Member> members;
+        };
+
+        struct Variable {
+            uint32_t id;
+            uint32_t pointerType;
+            uint32_t storageClass;
+        };
+
+        class Module {
+        public:
+            Module() noexcept
+                : _localSize{}
+            {}
+
+            [[nodiscard]] bool parse(std::span<const uint32_t> code) noexcept {
+                if (code.size() < headerWords || code[0] != spirvMagic)
+                    return false;
+
+                for (std::size_t at = headerWords; at < code.size();) {
+                    const uint32_t wordCount = code[at] >> 16;
+                    if (wordCount == 0 || at + wordCount > code.size())
+                        return false;
+
+                    read(static_cast<Op>(code[at] & 0xffff), code.subspan(at + 1, wordCount - 1));
+                    at += wordCount;
+                }
+
+                return _entryPoint.has_value();
+            }
+
+            [[nodiscard]] Reflection reflect() const noexcept {
+                Reflection reflection{};
+                reflection.stage = _entryPoint.value();
+                reflection.localSize = _localSize;
+
+                for (const Variable& variable : _variables) {
+                    const Type* pointer = find(variable.pointerType);
+                    if (!pointer || pointer->opcode != opTypePointer || pointer->operands.size() < 2)
+                        continue;
+
+                    const uint32_t pointee = pointer->operands[1];
+                    if (variable.storageClass == storagePushConstant) {
+                        reflection.pushConstantSize = std::max(reflection.pushConstantSize, sizeOf(pointee));
+                        continue;
+                    }
+
+                    if (variable.storageClass == storageInput) {
+                        if (reflection.stage == ShaderStage::vertex)
+                            addVertexInput(reflection.inputs, variable.id, pointee);
+                        continue;
+                    }
+
+                    if (variable.storageClass != storageUniformConstant
+                        && variable.storageClass != storageUniform
+                        && variable.storageClass != storageStorageBuffer)
+                        continue;
+
+                    const Decorations* decorations = findDecorations(variable.id);
+                    if (!decorations || !decorations->binding)
+                        continue;
+
+                    DescriptorBinding binding{};
+                    binding.set = decorations->set.value_or(0);
+                    binding.binding = decorations->binding.value();
+                    binding.count = 1;
+
+                    // arrays of descriptors share one binding
+                    uint32_t base = pointee;
+                    if (const Type* array = find(base); array && array->opcode == opTypeArray && array->operands.size() >= 2) {
+                        binding.count = constant(array->operands[1]);
+                        base = array->operands[0];
+                    } else if (array && array->opcode == opTypeRuntimeArray && !array->operands.empty()) {
+                        binding.count = 0;
+                        base = array->operands[0];
+                    }
+
+                    const std::optional<DescriptorKind> kind = descriptorKind(base, variable.storageClass);
+                    if (!kind)
+                        continue;
+
+                    binding.kind = kind.value();
+                    reflection.bindings.push_back(binding);
+                }
+
+                std::ranges::sort(reflection.bindings, [](const DescriptorBinding& left, const DescriptorBinding& right) {
+                    return left.set != right.set ? left.set < right.set : left.binding < right.binding;
+                });
+                std::ranges::sort(reflection.inputs, {}, &VertexInput::location);
+
+                return reflection;
+            }
+
+        private:
+            void read(Op opcode, std::span<const uint32_t> operands) noexcept {
+                switch (opcode) {
+                    case opEntryPoint:
+                        // only the first one is described
+                        if (!_entryPoint && !operands.empty())
+                            _entryPoint = executionStage(operands[0]);
+                        break;
+                    case opExecutionMode:
+                        if (operands.size() >= 5 && operands[1] == executionModeLocalSize)
+                            _localSize = { operands[2], operands[3], operands[4] };
+                        break;
+                    case opTypeInt:
+                    case opTypeFloat:
+                    case opTypeVector:
+                    case opTypeMatrix:
+                    case opTypeImage:
+                    case opTypeSampler:
+                    case opTypeSampledImage:
+                    case opTypeArray:
+                    case opTypeRuntimeArray:
+                    case opTypeStruct:
+                    case opTypePointer:
+                        if (!operands.empty())
+                            _types[operands[0]] = Type{ opcode, { operands.begin() + 1, operands.end() } };
+                        break;
+                    case opConstant:
+                        // 32-bit is all array lengths need
+                        if (operands.size() >= 3)
+                            _constants[operands[1]] = operands[2];
+                        break;
+                    case opVariable:
+                        if (operands.size() >= 3)
+                            _variables.push_back(Variable{ operands[1], operands[0], operands[2] });
+                        break;
+                    case opDecorate:
+                        if (operands.size() >= 2)
+                            decorate(_decorations[operands[0]], operands[1], operands.subspan(2));
+                        break;
+                    case opMemberDecorate:
+                        if (operands.size() >= 3)
+                            decorateMember(_decorations[operands[0]], operands[1], operands[2], operands.subspan(3));
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            static std::optional<ShaderStage> executionStage(uint32_t model) noexcept {
+                switch (model) {
+                    case modelVertex:
+                        return ShaderStage::vertex;
+                    case modelFragment:
+                        return ShaderStage::fragment;
+                    case modelGLCompute:
+                        return ShaderStage::compute;
+                    default:
+                        return std::nullopt;
+                }
+            }
+
+            static void decorate(Decorations& decorations, uint32_t decoration, std::span<const uint32_t> values) noexcept {
+                const std::optional<uint32_t> value = values.empty() ? std::nullopt : std::optional<uint32_t>{ values[0] };
+                switch (decoration) {
+                    case decorationBufferBlock:
+                        decorations.bufferBlock = true;
+                        break;
+                    case decorationArrayStride:
+                        decorations.arrayStride = value;
+                        break;
+                    case decorationLocation:
+                        decorations.location = value;
+                        break;
+                    case decorationBinding:
+                        decorations.binding = value;
+                        break;
+                    case decorationDescriptorSet:
+                        decorations.set = value;
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            static void decorateMember(Decorations& decorations, uint32_t member, uint32_t decoration, std::span<const uint32_t> values) noexcept {
+                if (values.empty() || (decoration != decorationOffset && decoration != decorationMatrixStride))
+                    return;
+
+                if (decorations.members.size() <= member)
+                    decorations.members.resize(member + 1);
+
+                if (decoration == decorationOffset)
+                    decorations.members[member].offset = values[0];
+                else
+                    decorations.members[member].matrixStride = values[0];
+            }
+
+            [[nodiscard]] const Type* find(uint32_t id) const noexcept {
+                const auto type = _types.find(id);
+                return type == _types.end() ? nullptr : &type->second;
+            }
+
+            [[nodiscard]] const Decorations* findDecorations(uint32_t id) const noexcept {
+                const auto decorations = _decorations.find(id);
+                return decorations == _decorations.end() ? nullptr : &decorations->second;
+            }
+
+            [[nodiscard]] uint32_t constant(uint32_t id) const noexcept {
+                const auto value = _constants.find(id);
+                return value == _constants.end() ? 0 : value->second;
+            }
+
+            // bytes the type covers in an explicitly laid out block, runtime arrays count as empty
+            [[nodiscard]] uint32_t sizeOf(uint32_t id, std::optional<uint32_t> matrixStride = std::nullopt) const noexcept {
+                const Type* type = find(id);
+                if (!type || type->operands.empty())
+                    return 0;
+
+                const std::vector<uint32_t>& operands = type->operands;
+                switch (type->opcode) {
+                    case opTypeInt:
+                    case opTypeFloat:
+                        return operands[0] / 8;
+                    case opTypeVector:
+                        return operands.size() >= 2 ? operands[1] * sizeOf(operands[0]) : 0;
+                    case opTypeMatrix:
+                        return operands.size() >= 2 ? operands[1] * matrixStride.value_or(sizeOf(operands[0])) : 0;
+                    case opTypeArray: {
+                        if (operands.size() < 2)
+                            return 0;
+
+                        const Decorations* decorations = findDecorations(id);
+                        const uint32_t stride = decorations && decorations->arrayStride ? decorations->arrayStride.value() : sizeOf(operands[0], matrixStride);
+                        return constant(operands[1]) * stride;
+                    }
+                    case opTypeStruct: {
+                        const Decorations* decorations = findDecorations(id);
+                        uint32_t end = 0;
+                        for (std::size_t i = 0; i < operands.size(); ++i) {
+                            const Member member = decorations && i < decorations->members.size() ? decorations->members[i] : Member{};
+                            end = std::max(end, member.offset.value_or(end) + sizeOf(operands[i], member.matrixStride));
+                        }
+                        return end;
+                    }
+                    default:
+                        return 0;
+                }
+            }
+
+            // scalars and vectors, the only inputs vertex buffers feed without further layout rules
+            void addVertexInput(std::vector<VertexInput>& inputs, uint32_t id, uint32_t typeId) const noexcept {
+                const Decorations* decorations = findDecorations(id);
+                if (!decorations || !decorations->location)
+                    return;
+
+                VertexInput input{};
+                input.location = decorations->location.value();
+                input.componentCount = 1;
+
+                const Type* type = find(typeId);
+                if (type && type->opcode == opTypeVector && type->operands.size() >= 2) {
+                    input.componentCount = type->operands[1];
+                    type = find(type->operands[0]);
+                }
+
+                if (!type || type->operands.empty())
+                    return;
+
+                if (type->opcode == opTypeFloat)
+                    input.type = ComponentType::floatingPoint;
+                else if (type->opcode == opTypeInt && type->operands.size() >= 2)
+                    input.type = type->operands[1] ? ComponentType::signedInteger : ComponentType::unsignedInteger;
+                else
+                    return;
+
+                input.componentSize = type->operands[0] / 8;
+                inputs.push_back(input);
+            }
+
+            [[nodiscard]] std::optional<DescriptorKind> descriptorKind(uint32_t id, uint32_t storageClass) const noexcept {
+                const Type* type = find(id);
+                if (!type)
+                    return std::nullopt;
+
+                if (storageClass == storageStorageBuffer)
+                    return DescriptorKind::storageBuffer;
+
+                if (storageClass == storageUniform) {
+                    // pre-1.3 SPIR-V marks storage buffers as uniform buffer blocks
+                    const Decorations* decorations = findDecorations(id);
+                    return decorations && decorations->bufferBlock ? DescriptorKind::storageBuffer : DescriptorKind::uniformBuffer;
+                }
+
+                switch (type->opcode) {
+                    case opTypeSampler:
+                        return DescriptorKind::sampler;
+                    case opTypeSampledImage:
+                        return DescriptorKind::combinedImageSampler;
+                    case opTypeImage: {
+                        // dim is the second operand, sampled the sixth: 1 with a sampler, 2 for storage
+                        if (type->operands.size() < 6)
+                            return std::nullopt;
+
+                        const bool storage = type->operands[5] == 2;
+                        if (type->operands[1] == imageDimBuffer)
+                            return storage ? DescriptorKind::storageTexelBuffer : DescriptorKind::uniformTexelBuffer;
+                        return storage ? DescriptorKind::storageImage : DescriptorKind::sampledImage;
+                    }
+                    default:
+                        return std::nullopt;
+                }
+            }
+
+            std::optional<ShaderStage> _entryPoint;
+            std::array<uint32_t, 3> _localSize;
+            std::unordered_map<uint32_t, Type> _types;
+            std::unordered_map<uint32_t, uint32_t> _constants;
+            std::unordered_map<uint32_t, Decorations> _decorations;
+            std::vector<Variable> _variables;
+        };
+    }
+
+    std::optional<Reflection> reflect(std::span<const uint32_t> code) noexcept {
+        Module module;
+        if (!module.parse(code))
+            return std::nullopt;
+
+        return module.reflect();
+    }
+}
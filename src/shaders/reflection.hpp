@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace tv::shader {
+    enum class ShaderStage : uint32_t {
+        vertex,
+        fragment,
+        compute
+    };
+
+    // values match VkDescriptorType
+    enum class DescriptorKind : uint32_t {
+        sampler,
+        combinedImageSampler,
+        sampledImage,
+        storageImage,
+        uniformTexelBuffer,
+        storageTexelBuffer,
+        uniformBuffer,
+        storageBuffer
+    };
+
+    enum class ComponentType : uint32_t {
+        floatingPoint,
+        signedInteger,
+        unsignedInteger
+    };
+
+    struct DescriptorBinding {
+        uint32_t set;
+        uint32_t binding;
+        DescriptorKind kind;
+        // zero for runtime-sized arrays
+        uint32_t count;
+    };
+
+    // a vertex shader input fed from a vertex buffer
+    struct VertexInput {
+        uint32_t location;
+        ComponentType type;
+        // bytes per component
+        uint32_t componentSize;
+        uint32_t componentCount;
+    };
+
+    struct Reflection {
+        ShaderStage stage;
+        // end of the push constant block, zero without one
+        uint32_t pushConstantSize;
+        // compute workgroup size, zero for other stages
+        std::array<uint32_t, 3> localSize;
+        // ordered by set, then binding
+        std::vector<DescriptorBinding> bindings;
+        // vertex stage only, ordered by location; built-ins are not listed
+        std::vector<VertexInput> inputs;
+    };
+
+    // reads the interface of the first entry point straight from the SPIR-V words,
+    // empty for anything that is not a module the parser understands
+    [[nodiscard]] std::optional<Reflection> reflect(std::span<const uint32_t> code) noexcept;
+}
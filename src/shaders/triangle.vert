@@ -12,13 +12,25 @@ vec3 colors[3] = vec3[](
     vec3(0.0, 0.0, 1.0)
 );
 
-layout (push_constant) uniform constants {
+struct Triangle {
     mat4 model;
-} Triangle;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Instances {
+    Triangle triangles[];
+} instances;
+
+layout(std430, set = 0, binding = 1) readonly buffer VisibleInstances {
+    uint indices[];
+} visible;
+
+layout(push_constant) uniform constants {
+    mat4 viewProjection;
+} Camera;
 
 layout(location = 0) out vec3 fragColor;
 
 void main() {
-    gl_Position = Triangle.model * vec4(positions[gl_VertexIndex], 0.0, 1.0);
+    gl_Position = Camera.viewProjection * instances.triangles[visible.indices[gl_InstanceIndex]].model * vec4(positions[gl_VertexIndex], 0.0, 1.0);
     fragColor = colors[gl_VertexIndex];
 }
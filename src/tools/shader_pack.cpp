@@ -0,0 +1,234 @@
+// build step: reflects the compiled shaders into a header of constants and embeds their words into the executable
+//
+// usage: shader_pack [--no-embed] <reflection header> <embedded source> <spv files...>
+// with --no-embed the source embeds nothing and the application reads the compiled files
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../shaders/reflection.hpp"
+
+namespace {
+    struct Shader {
+        std::string fileName;
+        // triangle.vert.spv becomes triangleVert
+        std::string identifier;
+        std::vector<uint32_t> code;
+        tv::shader::Reflection reflection;
+    };
+
+    std::string toIdentifier(std::string_view fileName) noexcept {
+        std::string_view stem = fileName;
+        if (stem.ends_with(".spv"))
+            stem.remove_suffix(4);
+
+        std::string identifier;
+        bool upper = false;
+        for (const char symbol : stem) {
+            if (!std::isalnum(static_cast<unsigned char>(symbol))) {
+                upper = !identifier.empty();
+                continue;
+            }
+
+            identifier.push_back(upper ? static_cast<char>(std::toupper(static_cast<unsigned char>(symbol))) : symbol);
+            upper = false;
+        }
+
+        return identifier;
+    }
+
+    std::optional<Shader> readShader(const std::filesystem::path& path) noexcept {
+        std::ifstream file{ path, std::ios::binary };
+        const std::vector<char> bytes{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+        if (bytes.empty() || bytes.size() % sizeof(uint32_t) != 0)
+            return std::nullopt;
+
+        Shader shader{};
+        shader.fileName = path.filename().string();
+        shader.identifier = toIdentifier(shader.fileName);
+        shader.code.resize(bytes.size() / sizeof(uint32_t));
+        std::memcpy(shader.code.data(), bytes.data(), bytes.size());
+
+        std::optional<tv::shader::Reflection> reflection = tv::shader::reflect(shader.code);
+        if (!reflection)
+            return std::nullopt;
+
+        shader.reflection = std::move(reflection.value());
+        return shader;
+    }
+
+    std::string_view stageName(tv::shader::ShaderStage stage) noexcept {
+        switch (stage) {
+            case tv::shader::ShaderStage::vertex:
+                return "vertex";
+            case tv::shader::ShaderStage::fragment:
+                return "fragment";
+            case tv::shader::ShaderStage::compute:
+                return "compute";
+        }
+
+        return "vertex";
+    }
+
+    std::string_view kindName(tv::shader::DescriptorKind kind) noexcept {
+        switch (kind) {
+            case tv::shader::DescriptorKind::sampler:
+                return "sampler";
+            case tv::shader::DescriptorKind::combinedImageSampler:
+                return "combinedImageSampler";
+            case tv::shader::DescriptorKind::sampledImage:
+                return "sampledImage";
+            case tv::shader::DescriptorKind::storageImage:
+                return "storageImage";
+            case tv::shader::DescriptorKind::uniformTexelBuffer:
+                return "uniformTexelBuffer";
+            case tv::shader::DescriptorKind::storageTexelBuffer:
+                return "storageTexelBuffer";
+            case tv::shader::DescriptorKind::uniformBuffer:
+                return "uniformBuffer";
+            case tv::shader::DescriptorKind::storageBuffer:
+                return "storageBuffer";
+        }
+
+        return "storageBuffer";
+    }
+
+    std::string writeReflectionHeader(const std::vector<Shader>& shaders) noexcept {
+        std::string text =
+            "// generated by shader_pack from the compiled shaders, do not edit\n"
+            "#pragma once\n"
+            "\n"
+            "#include <array>\n"
+            "#include <cstdint>\n"
+            "#include <string_view>\n"
+            "\n"
+            "#include \"shaders/reflection.hpp\"\n"
+            "\n"
+            "namespace tv::shader::reflection {\n";
+
+        for (const Shader& shader : shaders) {
+            const tv::shader::Reflection& reflection = shader.reflection;
+            if (&shader != &shaders.front())
+                text += "\n";
+            text += std::format("    struct {} {{\n", shader.identifier);
+            text += std::format("        inline static constexpr std::string_view FILE_NAME = \"{}\";\n", shader.fileName);
+            text += std::format("        inline static constexpr ShaderStage STAGE = ShaderStage::{};\n", stageName(reflection.stage));
+            text += std::format("        inline static constexpr uint32_t PUSH_CONSTANT_SIZE = {};\n", reflection.pushConstantSize);
+            text += std::format("        inline static constexpr std::array<uint32_t, 3> LOCAL_SIZE{{ {}, {}, {} }};\n",
+                reflection.localSize[0], reflection.localSize[1], reflection.localSize[2]);
+            text += std::format("        inline static constexpr std::array<DescriptorBinding, {}> BINDINGS{{", reflection.bindings.size());
+            for (std::size_t i = 0; i < reflection.bindings.size(); ++i) {
+                const tv::shader::DescriptorBinding& binding = reflection.bindings[i];
+                text += std::format("{}\n            DescriptorBinding{{ {}, {}, DescriptorKind::{}, {} }}",
+                    i == 0 ? "" : ",", binding.set, binding.binding, kindName(binding.kind), binding.count);
+            }
+            text += reflection.bindings.empty() ? "};\n" : "\n        };\n";
+            text += "    };\n";
+        }
+
+        text += "}\n";
+        return text;
+    }
+
+    std::string writeEmbeddedSource(const std::vector<Shader>& shaders, bool embed) noexcept {
+        std::string text =
+            "// generated by shader_pack from the compiled shaders, do not edit\n"
+            "#include \"shaders/embedded_shaders.hpp\"\n"
+            "\n"
+            "namespace tv::shader {\n";
+
+        if (!embed || shaders.empty()) {
+            text +=
+                "    std::span<const uint32_t> findEmbeddedShader(std::string_view) noexcept {\n"
+                "        return {};\n"
+                "    }\n"
+                "}\n";
+
+            return text;
+        }
+
+        text += "    namespace {\n";
+
+        for (const Shader& shader : shaders) {
+            text += std::format("        constexpr uint32_t {}Code[] = {{", shader.identifier);
+            for (std::size_t i = 0; i < shader.code.size(); ++i)
+                text += std::format("{}{:#010x},", i % 8 == 0 ? "\n            " : " ", shader.code[i]);
+            text += "\n        };\n\n";
+        }
+
+        text +=
+            "        struct EmbeddedShader {\n"
+            "            std::string_view fileName;\n"
+            "            std::span<const uint32_t> code;\n"
+            "        };\n"
+            "\n"
+            "        constexpr EmbeddedShader embeddedShaders[] = {\n";
+        for (const Shader& shader : shaders)
+            text += std::format("            EmbeddedShader{{ \"{}\", {}Code }},\n", shader.fileName, shader.identifier);
+        text +=
+            "        };\n"
+            "    }\n"
+            "\n"
+            "    std::span<const uint32_t> findEmbeddedShader(std::string_view fileName) noexcept {\n"
+            "        for (const EmbeddedShader& shader : embeddedShaders)\n"
+            "            if (shader.fileName == fileName)\n"
+            "                return shader.code;\n"
+            "\n"
+            "        return {};\n"
+            "    }\n"
+            "}\n";
+
+        return text;
+    }
+
+    // leaves unchanged outputs alone so their dependents are not rebuilt
+    bool writeIfChanged(const std::filesystem::path& path, const std::string& text) noexcept {
+        {
+            std::ifstream current{ path, std::ios::binary };
+            if (current && std::string{ std::istreambuf_iterator<char>{ current }, std::istreambuf_iterator<char>{} } == text)
+                return true;
+        }
+
+        std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+        file << text;
+        return static_cast<bool>(file);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const bool embed = argc < 2 || std::string_view{ argv[1] } != "--no-embed";
+    const int first = embed ? 1 : 2;
+    if (argc < first + 3) {
+        std::cerr << "usage: shader_pack [--no-embed] <reflection header> <embedded source> <spv files...>\n";
+        return 1;
+    }
+
+    std::vector<Shader> shaders;
+    for (int i = first + 2; i < argc; ++i) {
+        std::optional<Shader> shader = readShader(argv[i]);
+        if (!shader) {
+            std::cerr << std::format("shader_pack: {} is not a SPIR-V module\n", argv[i]);
+            return 1;
+        }
+
+        shaders.push_back(std::move(shader.value()));
+    }
+
+    if (!writeIfChanged(argv[first], writeReflectionHeader(shaders))
+        || !writeIfChanged(argv[first + 1], writeEmbeddedSource(shaders, embed))) {
+        std::cerr << "shader_pack: failed to write the outputs\n";
+        return 1;
+    }
+
+    return 0;
+}
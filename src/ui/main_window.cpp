@@ -1,5 +1,8 @@
 #include "main_window.hpp"
 
+#include <array>
+
+#include "../scene/scene_updater.hpp"
 #include "../utility/config.hpp"
 
 namespace tv::ui {
@@ -13,10 +16,27 @@ namespace tv::ui {
     }
 
     void MainWindow::processEvents(Renderer& renderer, Scene* scene) noexcept {
+        // frame N renders from one snapshot while the updater extracts frame N + 1 into the other
+        std::array<SceneSnapshot, 2> snapshots;
+        SceneUpdater updater{ scene };
+        updater.begin(&snapshots[0]);
+        updater.end();
+
+        std::size_t front = 0;
         while (!glfwWindowShouldClose(_window)) {
+            // nothing can be presented while minimized, sleep until the window changes
+            if (glfwGetWindowAttrib(_window, GLFW_ICONIFIED)) {
+                glfwWaitEvents();
+                continue;
+            }
+
+            // events are handled while no step runs, so their callbacks may edit the scene
             glfwPollEvents();
-            renderer.render(scene);
-            drawFrameRate();
+            updater.begin(&snapshots[1 - front]);
+            renderer.render(&snapshots[front]);
+            drawFrameRate(renderer);
+            updater.end();
+            front = 1 - front;
         }
     }
 
@@ -40,7 +60,7 @@ namespace tv::ui {
         glfwTerminate();
     }
 
-    void MainWindow::drawFrameRate() noexcept {
+    void MainWindow::drawFrameRate(const Renderer& renderer) noexcept {
         static int numberOfFrames = 0;
         static double lastTime = 0;
         const double currentTime = glfwGetTime();
@@ -49,7 +69,18 @@ namespace tv::ui {
         if (delta >= 1) {
             assert(delta != 0);
             const int frameRate = std::max(1, numberOfFrames / (int)delta);
-            glfwSetWindowTitle(_window, std::format("{} in {} fps", constants::config::WINDOW_TITLE, frameRate).c_str());
+            const FrameTimings& timings = renderer.getFrameTimings();
+            const FrameTimingStats frame = timings.getStats(&FrameTiming::frame);
+            const FrameTimingStats gpu = timings.getStats(&FrameTiming::gpu);
+            glfwSetWindowTitle(_window, std::format(
+                "{} in {} fps | frame min {:.2f} avg {:.2f} p99 {:.2f} ms | gpu avg {:.2f} ms",
+                constants::config::WINDOW_TITLE,
+                frameRate,
+                frame.min,
+                frame.avg,
+                frame.p99,
+                gpu.avg
+            ).c_str());
             lastTime = currentTime;
             numberOfFrames = -1;
         }
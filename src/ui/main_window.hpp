@@ -22,7 +22,7 @@ namespace tv::ui {
 
         ~MainWindow();
 
-        void drawFrameRate() noexcept;
+        void drawFrameRate(const Renderer& renderer) noexcept;
 
         GLFWwindow* _window;
     };
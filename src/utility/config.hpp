@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace tv::constants {
     struct config {
         // general
@@ -7,10 +10,56 @@ namespace tv::constants {
         inline static constexpr char WINDOW_TITLE[] = "Test Vulkan";
         inline static constexpr int WINDOW_MAIN_WIDTH = 800;
         inline static constexpr int WINDOW_MAIN_HEIGHT = 600;
+        inline static constexpr char HEADLESS_ARGUMENT[] = "--headless";
+        inline static constexpr std::size_t HEADLESS_FRAME_COUNT = 16;
 
         // vulkan
         inline static constexpr char VULKAN_EXT_DEBUG[] = "VK_EXT_debug_utils";
         inline static constexpr char VULKAN_LAYER_VALIDATION[] = "VK_LAYER_KHRONOS_validation";
         inline static constexpr char VULKAN_SHADER_ENTRY_POINT_NAME[] = "main";
+        // without change notifications, how often reload lists the shader directory
+        inline static constexpr uint32_t SHADER_POLL_INTERVAL_MS = 250;
+        inline static constexpr std::size_t VULKAN_MIN_INSTANCE_CAPACITY = 1024;
+        inline static constexpr uint32_t VULKAN_MAX_DESCRIPTOR_SETS = 16;
+        inline static constexpr uint32_t VULKAN_MAX_STORAGE_BUFFER_DESCRIPTORS = 3 * VULKAN_MAX_DESCRIPTOR_SETS;
+        inline static constexpr uint32_t VULKAN_CULL_WORKGROUP_SIZE = 64;
+        inline static constexpr std::size_t VULKAN_MIN_RECORDING_CHUNK_SIZE = 1024;
+        inline static constexpr std::size_t VULKAN_HEADLESS_FRAMES_IN_FLIGHT = 2;
+        inline static constexpr std::size_t VULKAN_FRAMES_IN_FLIGHT = 2;
+        inline static constexpr std::size_t FRAME_TIMINGS_CAPACITY = 512;
+        inline static constexpr uint64_t VULKAN_MEMORY_BLOCK_SIZE = 64ull << 20;
+        inline static constexpr uint64_t VULKAN_MEMORY_MIN_ALLOCATION = 256;
+        inline static constexpr uint64_t VULKAN_MIN_STAGING_CAPACITY = 4ull << 20;
+        inline static constexpr uint64_t VULKAN_STAGING_ALIGNMENT = 64;
+        inline static constexpr uint32_t VULKAN_PIPELINE_CACHE_MAGIC = 0x54565043; // "TVPC"
+
+        // scene
+        inline static constexpr std::size_t SCENE_CHUNK_BYTES = 16 << 10;
+        inline static constexpr std::size_t SCENE_CHUNK_ALIGNMENT = 64;
+        inline static constexpr std::size_t SCENE_CHUNK_CAPACITY = 128;
+        inline static constexpr std::size_t SCENE_BVH_MAX_LEAF_SIZE = 4;
+        inline static constexpr std::size_t SCENE_BVH_BIN_COUNT = 16;
+        inline static constexpr float SCENE_BVH_REBUILD_COST_RATIO = 1.5f;
+        inline static constexpr std::size_t SCENE_BVH_CULL_SUBTREES = 64;
+        inline static constexpr std::size_t SCENE_BVH_PARALLEL_CULL_MIN_IDS = 16 << 10;
+        inline static constexpr std::size_t SCENE_TRANSFORM_JOB_CHUNKS = 4;
+        inline static constexpr std::size_t SCENE_EXTRACT_JOB_CHUNKS = 16;
+
+        // jobs
+        inline static constexpr std::size_t JOB_QUEUE_CAPACITY = 4096;
+        inline static constexpr std::size_t JOB_SPIN_COUNT = 64;
+
+        // files
+        inline static constexpr uint32_t FILE_IO_QUEUE_DEPTH = 256;
+        inline static constexpr std::size_t FILE_IO_MAX_READ_SIZE = 1 << 30;
+
+        // benchmark
+        inline static constexpr std::size_t RECORDING_BENCHMARK_INSTANCE_COUNT = 1 << 20;
+        inline static constexpr std::size_t RECORDING_BENCHMARK_ITERATIONS = 32;
+        inline static constexpr std::size_t JOB_BENCHMARK_JOB_COUNT = 1 << 16;
+        inline static constexpr std::size_t JOB_BENCHMARK_ITEM_COUNT = 1 << 22;
+        inline static constexpr std::size_t JOB_BENCHMARK_ITERATIONS = 16;
+        inline static constexpr std::size_t TRANSFORM_BENCHMARK_MATRIX_COUNT = 1 << 20;
+        inline static constexpr std::size_t TRANSFORM_BENCHMARK_ITERATIONS = 16;
     };
 }
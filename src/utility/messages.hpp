@@ -15,8 +15,34 @@ namespace tv::constants {
         inline static constexpr char VULKAN_SWAPCHAIN_CREATION_STARTED[] = "Swapchain creation started";
         inline static constexpr char VULKAN_GETTING_QUEUE_STARTED[] = "Getting queue started";
         inline static constexpr char VULKAN_GRAPHICS_PIPELINE_CREATION_STARTED[] = "Graphics pipeline creation started";
+        inline static constexpr char VULKAN_COMPUTE_PIPELINE_CREATION_STARTED[] = "Compute pipeline creation started";
+        inline static constexpr char VULKAN_GPU_CULLING_ENABLED[] = "GPU culling enabled";
+        inline static constexpr char VULKAN_DYNAMIC_RENDERING_ENABLED[] = "Dynamic rendering enabled";
         inline static constexpr char VULKAN_FRAMEBUFFER_CREATED[] = "Framebuffer created";
         inline static constexpr char VULKAN_COMMAND_POOL_CREATION_STARTED[] = "Command pool creation started";
+        inline static constexpr char VULKAN_HEADLESS_MODE[] = "Headless mode, rendering offscreen";
+        inline static constexpr char VULKAN_OFFSCREEN_TARGETS_CREATION_STARTED[] = "Offscreen targets creation started";
+        inline static constexpr char HEADLESS_FRAMES_RENDERED[] = "Headless frames rendered";
+        inline static constexpr char HEADLESS_VISIBLE_INSTANCES[] = "Visible instances";
+        inline static constexpr char HEADLESS_FRAME_WRITTEN[] = "Frame written";
+        inline static constexpr char VULKAN_MEMORY_STATS[] = "Device memory";
+        inline static constexpr char VULKAN_GPU_TIMESTAMPS_ENABLED[] = "GPU timestamps enabled";
+        inline static constexpr char VULKAN_PIPELINE_CACHE_LOADED[] = "Pipeline cache loaded";
+        inline static constexpr char VULKAN_PIPELINE_CACHE_REJECTED[] = "Pipeline cache does not match the device, starting empty";
+        inline static constexpr char VULKAN_PIPELINE_CACHE_SAVED[] = "Pipeline cache saved";
+        inline static constexpr char SCENE_TRANSFORM_KERNEL[] = "Transform kernel";
+        inline static constexpr char VULKAN_RECORDING_BENCHMARK[] = "Recording benchmark";
+        inline static constexpr char JOB_WORKERS[] = "Job system workers";
+        inline static constexpr char FILE_IO_URING_ENABLED[] = "io_uring file reads enabled";
+        inline static constexpr char JOB_BENCHMARK_OVERHEAD[] = "Job overhead benchmark";
+        inline static constexpr char JOB_BENCHMARK_SCALING[] = "Job scaling benchmark";
+        inline static constexpr char TRANSFORM_BENCHMARK[] = "Transform benchmark";
+        inline static constexpr char VULKAN_TRANSFER_QUEUE_FAMILY[] = "Transfer queue family";
+        inline static constexpr char VULKAN_STAGING_RING_RESIZED[] = "Staging ring resized";
+        inline static constexpr char SHADER_WATCH_STARTED[] = "Watching shaders";
+        inline static constexpr char SHADER_WATCH_POLLING[] = "Polling shaders for changes";
+        inline static constexpr char SHADER_RELOADED[] = "Shader reloaded";
+        inline static constexpr char VULKAN_PIPELINE_REBUILT[] = "Pipeline rebuilt";
 
         // errors
         inline static constexpr char VULKAN_INSTANCE_CREATION_FAILED[] = "Failed to create Vulkan instance";
@@ -35,8 +61,27 @@ namespace tv::constants {
         inline static constexpr char VULKAN_FRAMEBUFFER_CREATION_FAILED[] = "Failed to create framebuffer";
         inline static constexpr char VULKAN_COMMAND_POOL_CREATION_FAILED[] = "Failed to create command pool";
         inline static constexpr char VULKAN_COMMAND_BUFFER_ALLOCATION_FAILED[] = "Failed to allocate command buffer";
+        inline static constexpr char VULKAN_SECONDARY_COMMAND_BUFFER_ALLOCATION_FAILED[] = "Failed to allocate secondary command buffer";
         inline static constexpr char VULKAN_MAIN_COMMAND_BUFFER_ALLOCATION_FAILED[] = "Failed to allocate main command buffer";
+        inline static constexpr char VULKAN_DESCRIPTOR_SET_LAYOUT_CREATION_FAILED[] = "Failed to create descriptor set layout";
+        inline static constexpr char VULKAN_DESCRIPTOR_POOL_CREATION_FAILED[] = "Failed to create descriptor pool";
+        inline static constexpr char VULKAN_DESCRIPTOR_SET_ALLOCATION_FAILED[] = "Failed to allocate descriptor set";
+        inline static constexpr char VULKAN_BUFFER_CREATION_FAILED[] = "Failed to create buffer";
+        inline static constexpr char VULKAN_MEMORY_ALLOCATION_FAILED[] = "Failed to allocate device memory";
+        inline static constexpr char VULKAN_NO_SUITABLE_MEMORY_TYPE[] = "Failed to find suitable memory type";
+        inline static constexpr char VULKAN_MEMORY_MAP_FAILED[] = "Failed to map device memory";
+        inline static constexpr char VULKAN_MEMORY_INVALIDATE_FAILED[] = "Failed to invalidate mapped device memory";
+        inline static constexpr char VULKAN_STAGING_ALLOCATION_FAILED[] = "Failed to allocate staging memory";
+        inline static constexpr char VULKAN_IMAGE_CREATION_FAILED[] = "Failed to create image";
+        inline static constexpr char VULKAN_QUERY_POOL_CREATION_FAILED[] = "Failed to create query pool";
+        inline static constexpr char VULKAN_PIPELINE_CACHE_CREATION_FAILED[] = "Failed to create pipeline cache";
 
         inline static constexpr char FILE_DONT_EXIST[] = "File does not exist";
+        inline static constexpr char FILE_WRITE_FAILED[] = "Failed to write file";
+        inline static constexpr char FILE_MAP_FAILED[] = "Failed to map file, reading it instead";
+        inline static constexpr char FILE_EXECUTABLE_DIRECTORY_UNKNOWN[] = "Executable directory unknown, using the working directory";
+        inline static constexpr char FILE_IO_URING_SUBMIT_FAILED[] = "Failed to submit io_uring reads";
+        inline static constexpr char SHADER_WATCH_FAILED[] = "Failed to watch shaders, hot reload disabled";
+        inline static constexpr char SHADER_REFLECTION_FAILED[] = "Failed to reflect shader, the code is not a SPIR-V module";
     };
 }
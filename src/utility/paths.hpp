@@ -4,9 +4,15 @@
 
 namespace tv::constants {
     struct path {
-        inline static const std::filesystem::path BUILD_PATH = std::filesystem::current_path() / "..";
+        // set by the build, only the default place to look for shader files overriding the embedded ones
+        inline static const std::filesystem::path BUILD_PATH = TV_BUILD_DIRECTORY;
+        // shaders are embedded unless built with TV_EMBED_SHADERS off, files written here override them at runtime
         inline static const std::filesystem::path SHADERS_PATH = BUILD_PATH / "shaders";
         inline static const std::filesystem::path TRIANGLE_VERTEX_PATH = SHADERS_PATH / "triangle.vert.spv";
         inline static const std::filesystem::path TRIANGLE_FRAGMENT_PATH = SHADERS_PATH / "triangle.frag.spv";
+        inline static const std::filesystem::path CULL_COMPUTE_PATH = SHADERS_PATH / "cull.comp.spv";
+        // written next to the executable, which keeps working once the build directory is moved or gone
+        inline static const std::filesystem::path PIPELINE_CACHE_FILE = "pipeline.cache";
+        inline static const std::filesystem::path HEADLESS_FRAME_FILE = "headless.ppm";
     };
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <optional>
+#include <string>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 #include <vulkan/vulkan.hpp>
@@ -14,6 +16,8 @@ namespace tv::structures {
 
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        // a dedicated copy family when the device has one, the graphics family otherwise
+        std::optional<uint32_t> transferFamily;
     };
 
     struct VSwapChainDetails {
@@ -22,35 +26,39 @@ namespace tv::structures {
         std::vector<vk::PresentModeKHR> presentMods;
     };
 
-    struct VSwapChainFrame {
-        vk::Image image;
-        vk::ImageView imageView;
-        vk::Framebuffer framebuffer;
-        vk::CommandBuffer commandBuffer;
-        vk::Semaphore imageAvailable;
-        vk::Semaphore renderFinished;
-        vk::Fence inFlight;
+    // prefixed to the serialized vk::PipelineCache so a blob from another device or driver is never fed back
+    struct VPipelineCacheHeader {
+        uint32_t magic;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
     };
 
-    struct VSwapChainBundle {
-        vk::SwapchainKHR swapChain;
-        std::vector<VSwapChainFrame> frames;
-        vk::Format format;
+    // tightly packed pixels of a headless frame, valid until that frame slot is rendered again
+    struct VHostFrame {
+        const uint8_t* pixels;
         vk::Extent2D extent;
+        vk::Format format;
+        std::size_t rowPitch;
     };
 
     struct VGraphicsPipelineInBundle {
         vk::Device device;
+        vk::PipelineCache pipelineCache;
         std::string vertexFilepath;
         std::string fragmentFilepath;
-        vk::Extent2D swapchainExtent;
         vk::Format swapchainImageFormat;
+        vk::ImageLayout finalLayout;
+        // no render pass or framebuffers, attachments are described at record time
+        bool dynamicRendering;
     };
 
-    struct VGraphicsPipelineBundle {
-        vk::PipelineLayout layout;
-        vk::RenderPass renderpass;
-        vk::Pipeline pipeline;
+    struct VComputePipelineInBundle {
+        vk::Device device;
+        vk::PipelineCache pipelineCache;
+        std::string computeFilepath;
     };
 
     struct VFramebufferInput {
@@ -58,10 +66,4 @@ namespace tv::structures {
         vk::RenderPass renderpass;
         vk::Extent2D swapchainExtent;
     };
-
-    struct VCommandBufferInput {
-        vk::Device device;
-        vk::CommandPool commandPool;
-        std::vector<VSwapChainFrame>& frames;
-    };
 }
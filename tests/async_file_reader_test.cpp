@@ -0,0 +1,107 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+#include "services/async_file_reader.hpp"
+
+namespace {
+    // more files than the ring has entries, so later reads wait for earlier ones to complete
+    constexpr std::size_t fileCount = 300;
+    constexpr std::size_t fileSizes[] = { 0, 1, 100, 4096, 65537, 1 << 20 };
+
+    char expectedByte(std::size_t file, std::size_t position) {
+        return static_cast<char>((file * 131 + position) & 0xff);
+    }
+
+    struct Read {
+        std::size_t file;
+        uint64_t offset;
+        std::vector<char> buffer;
+        std::size_t bytesRead;
+        bool succeeded;
+        bool called;
+    };
+
+    std::vector<std::filesystem::path> writeFiles(const std::filesystem::path& directory) {
+        std::filesystem::create_directories(directory);
+
+        std::vector<std::filesystem::path> paths;
+        for (std::size_t file = 0; file < fileCount; ++file) {
+            std::string contents(fileSizes[file % std::size(fileSizes)], '\0');
+            for (std::size_t position = 0; position < contents.size(); ++position)
+                contents[position] = expectedByte(file, position);
+
+            paths.push_back(directory / std::to_string(file));
+            std::ofstream{ paths.back(), std::ios::binary }.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        }
+
+        return paths;
+    }
+
+    void testBatch(tv::service::AsyncFileReader& reader, const std::vector<std::filesystem::path>& paths, bool poll) {
+        std::vector<Read> reads;
+        reads.reserve(paths.size() + 1);
+        for (std::size_t file = 0; file < paths.size(); ++file) {
+            const std::size_t size = fileSizes[file % std::size(fileSizes)];
+            // every third read is a range from the middle, sized past the end of the file
+            const uint64_t offset = file % 3 == 0 ? size / 2 : 0;
+            reads.push_back(Read{ file, offset, std::vector<char>(size), 0, false, false });
+        }
+        reads.push_back(Read{ paths.size(), 0, std::vector<char>(16), 0, false, false });
+
+        for (Read& read : reads) {
+            const std::filesystem::path path = read.file < paths.size() ? paths[read.file] : paths.front().parent_path() / "missing";
+            reader.queue(path.string(), std::span<char>{ read.buffer }, read.offset, [&read](std::size_t bytesRead, bool succeeded) {
+                TV_CHECK(!read.called);
+                read.bytesRead = bytesRead;
+                read.succeeded = succeeded;
+                read.called = true;
+            });
+        }
+
+        if (poll) {
+            reader.submit();
+            while (reader.getPendingCount() > 0)
+                reader.poll();
+        } else {
+            reader.wait();
+        }
+        TV_CHECK(reader.getPendingCount() == 0);
+
+        for (const Read& read : reads) {
+            TV_CHECK(read.called);
+            if (read.file == paths.size()) {
+                TV_CHECK(!read.succeeded);
+                continue;
+            }
+
+            TV_CHECK(read.succeeded);
+            TV_CHECK(read.bytesRead == read.buffer.size() - read.offset);
+            for (std::size_t position = 0; position < read.bytesRead; ++position)
+                TV_CHECK(read.buffer[position] == expectedByte(read.file, read.offset + position));
+        }
+    }
+}
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "tv_async_file_reader_test";
+    const std::vector<std::filesystem::path> paths = writeFiles(directory);
+
+    // the ring may be unavailable here, then this runs the fallback as well
+    tv::service::AsyncFileReader ringReader;
+    testBatch(ringReader, paths, false);
+    if (ringReader.usesIoUring())
+        testBatch(ringReader, paths, true);
+
+    tv::service::AsyncFileReader fallbackReader{ false };
+    TV_CHECK(!fallbackReader.usesIoUring());
+    testBatch(fallbackReader, paths, false);
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
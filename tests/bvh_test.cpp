@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <glm.hpp>
+#include <gtc/matrix_transform.hpp>
+
+#include "check.hpp"
+#include "scene/bvh.hpp"
+#include "scene/frustum.hpp"
+#include "scene/instance_bvh.hpp"
+#include "utility/config.hpp"
+
+namespace {
+    constexpr std::size_t queryCount = 200;
+
+    // the same intersection the tree uses, over every used id
+    std::optional<tv::BvhHit> bruteRaycast(const tv::Bvh& bvh, const glm::vec3& origin, const glm::vec3& direction) {
+        const glm::vec3 unitDirection = glm::normalize(direction);
+        std::optional<tv::BvhHit> closest;
+        for (uint32_t id = 0; id < bvh.getIdCount(); ++id) {
+            const glm::vec4& sphere = bvh.getSphere(id);
+            if (sphere.w < 0.0f)
+                continue;
+
+            const glm::vec3 offset = origin - glm::vec3(sphere);
+            const float b = glm::dot(offset, unitDirection);
+            const float c = glm::dot(offset, offset) - sphere.w * sphere.w;
+            const float discriminant = b * b - c;
+            if (discriminant < 0.0f)
+                continue;
+
+            const float root = std::sqrt(discriminant);
+            const float distance = -b - root >= 0.0f ? -b - root : -b + root;
+            if (distance >= 0.0f && (!closest || distance < closest->distance))
+                closest = tv::BvhHit{ id, distance };
+        }
+
+        return closest;
+    }
+
+    std::vector<uint32_t> bruteCull(const tv::Bvh& bvh, const tv::Frustum& frustum) {
+        std::vector<uint32_t> visible;
+        for (uint32_t id = 0; id < bvh.getIdCount(); ++id) {
+            const glm::vec4& sphere = bvh.getSphere(id);
+            if (sphere.w >= 0.0f && frustum.intersectsSphere(glm::vec3(sphere), sphere.w))
+                visible.push_back(id);
+        }
+
+        return visible;
+    }
+
+    std::vector<uint32_t> bruteQueryPoint(const tv::Bvh& bvh, const glm::vec3& point) {
+        std::vector<uint32_t> hits;
+        for (uint32_t id = 0; id < bvh.getIdCount(); ++id) {
+            const glm::vec4& sphere = bvh.getSphere(id);
+            const glm::vec3 offset = point - glm::vec3(sphere);
+            if (sphere.w >= 0.0f && glm::dot(offset, offset) <= sphere.w * sphere.w)
+                hits.push_back(id);
+        }
+
+        return hits;
+    }
+
+    // every query against the tree matches the brute force answer over spheres spread within extent
+    void checkQueries(const tv::Bvh& bvh, float extent, std::mt19937& random) {
+        std::uniform_real_distribution<float> position{ -1.5f * extent, 1.5f * extent };
+        std::uniform_real_distribution<float> unit{ -1.0f, 1.0f };
+        const auto randomPoint = [&] { return glm::vec3(position(random), position(random), position(random)); };
+        const auto randomDirection = [&] {
+            glm::vec3 direction{ 0.0f };
+            while (glm::dot(direction, direction) < 1e-4f)
+                direction = glm::vec3(unit(random), unit(random), unit(random));
+            return direction;
+        };
+
+        std::vector<uint32_t> result;
+        for (std::size_t query = 0; query < queryCount / 10; ++query) {
+            // cameras inside the spheres, and one far enough back for whole subtrees to be inside the frustum
+            const glm::vec3 eye = query == 0 ? glm::vec3(0.0f, 0.0f, 4.0f * extent) : randomPoint();
+            const glm::vec3 target = query == 0 ? glm::vec3(0.0f) : eye + randomDirection();
+            const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 8.0f * extent);
+            const tv::Frustum frustum{ projection * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)) };
+
+            result.clear();
+            bvh.cull(frustum, result);
+            std::ranges::sort(result);
+            TV_CHECK(result == bruteCull(bvh, frustum));
+        }
+
+        for (std::size_t query = 0; query < queryCount; ++query) {
+            const glm::vec3 origin = randomPoint();
+            const glm::vec3 direction = randomDirection();
+            const std::optional<tv::BvhHit> hit = bvh.raycast(origin, direction);
+            const std::optional<tv::BvhHit> expected = bruteRaycast(bvh, origin, direction);
+            TV_CHECK(hit.has_value() == expected.has_value());
+            if (hit) {
+                // two spheres may sit at the same distance, then either id is the closest
+                TV_CHECK(hit->distance == expected->distance);
+                TV_CHECK(bvh.getSphere(hit->id).w >= 0.0f);
+            }
+        }
+
+        // points around sphere centers land inside a few of them
+        std::normal_distribution<float> nearby{ 0.0f, 2.0f };
+        for (std::size_t query = 0; query < queryCount; ++query) {
+            const glm::vec4& sphere = bvh.getSphere(static_cast<uint32_t>(random() % bvh.getIdCount()));
+            const glm::vec3 point = query % 2 == 0 ? randomPoint() : glm::vec3(sphere) + glm::vec3(nearby(random), nearby(random), nearby(random));
+
+            result.clear();
+            bvh.queryPoint(point, result);
+            std::ranges::sort(result);
+            TV_CHECK(result == bruteQueryPoint(bvh, point));
+        }
+    }
+
+    // small trees cull on the calling thread, large ones as jobs over their subtrees
+    void testBvh(std::size_t idCount) {
+        constexpr float extent = 100.0f;
+        std::mt19937 random{ static_cast<uint32_t>(idCount) };
+        std::uniform_real_distribution<float> position{ -extent, extent };
+        std::uniform_real_distribution<float> radius{ 0.1f, 5.0f };
+        std::uniform_int_distribution<int> used{ 0, 4 };
+
+        tv::Bvh bvh;
+        bvh.resize(idCount);
+        for (uint32_t id = 0; id < idCount; ++id) {
+            const float sphereRadius = used(random) == 0 ? -1.0f : radius(random);
+            bvh.setSphere(id, glm::vec4(position(random), position(random), position(random), sphereRadius));
+        }
+        bvh.build();
+        checkQueries(bvh, extent, random);
+
+        // moving every sphere and refitting keeps the answers, ids dropped since the build are left out
+        std::normal_distribution<float> step{ 0.0f, 1.0f };
+        for (uint32_t id = 0; id < idCount; ++id) {
+            glm::vec4 sphere = bvh.getSphere(id);
+            sphere += glm::vec4(step(random), step(random), step(random), 0.0f);
+            if (id % 7 == 0)
+                sphere.w = -1.0f;
+            bvh.setSphere(id, sphere);
+        }
+        bvh.refit();
+        checkQueries(bvh, extent, random);
+    }
+
+    // the scene sizes the tree in whole chunks, the last one only partly alive
+    struct Instances {
+        static constexpr std::size_t capacity = tv::constants::config::SCENE_CHUNK_CAPACITY;
+        static constexpr std::size_t chunkCount = 6;
+        static constexpr std::size_t lastChunkCount = 37;
+
+        std::vector<glm::mat4> worlds = std::vector<glm::mat4>(chunkCount * capacity, glm::mat4(0.0f));
+
+        void update(tv::InstanceBvh& instanceBvh) const {
+            for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+                instanceBvh.updateChunk(chunk, worlds.data() + chunk * capacity, chunk + 1 < chunkCount ? capacity : lastChunkCount, 1.0f);
+            instanceBvh.commit();
+        }
+    };
+
+    // a tree built from scratch over the same spheres, its cost is what a rebuild leaves behind
+    float rebuiltCost(const tv::Bvh& bvh) {
+        tv::Bvh rebuilt;
+        rebuilt.resize(bvh.getIdCount());
+        for (uint32_t id = 0; id < bvh.getIdCount(); ++id)
+            rebuilt.setSphere(id, bvh.getSphere(id));
+        rebuilt.build();
+        return rebuilt.getCost();
+    }
+
+    void testInstanceBvh() {
+        constexpr float extent = 50.0f;
+        constexpr std::size_t instanceCount = Instances::chunkCount * Instances::capacity;
+        std::mt19937 random{ 99 };
+        std::uniform_real_distribution<float> position{ -extent, extent };
+        std::uniform_real_distribution<float> scale{ 0.5f, 3.0f };
+
+        Instances instances;
+        for (std::size_t i = 0; i < instanceCount; ++i) {
+            // zero matrices are unused slots
+            if (i % 5 == 0)
+                continue;
+
+            const glm::mat4 translation = glm::translate(glm::mat4(1.0f), glm::vec3(position(random), position(random), position(random)));
+            instances.worlds[i] = glm::scale(translation, glm::vec3(scale(random), scale(random), scale(random)));
+        }
+
+        tv::InstanceBvh instanceBvh;
+        TV_CHECK(instanceBvh.resize(instanceCount));
+        TV_CHECK(!instanceBvh.resize(instanceCount));
+        instances.update(instanceBvh);
+        const tv::Bvh& bvh = instanceBvh.getBvh();
+        TV_CHECK(bvh.getCost() == rebuiltCost(bvh));
+        for (std::size_t i = 0; i < instanceCount; ++i)
+            TV_CHECK((bvh.getSphere(static_cast<uint32_t>(i)).w >= 0.0f) == (i % 5 != 0 && i < instanceCount - Instances::capacity + Instances::lastChunkCount));
+        checkQueries(bvh, extent, random);
+
+        // small moves and removed instances are refitted into the existing tree
+        std::normal_distribution<float> step{ 0.0f, 0.05f };
+        for (std::size_t i = 0; i < instanceCount; ++i) {
+            if (i % 11 == 0)
+                instances.worlds[i] = glm::mat4(0.0f);
+            else if (instances.worlds[i][3][3] != 0.0f)
+                instances.worlds[i][3] += glm::vec4(step(random), step(random), step(random), 0.0f);
+        }
+        instances.update(instanceBvh);
+        checkQueries(bvh, extent, random);
+
+        // scattered far apart the refitted tree turns loose, so commit rebuilds it
+        std::uniform_real_distribution<float> scattered{ -20.0f * extent, 20.0f * extent };
+        for (auto& world : instances.worlds) {
+            if (world[3][3] != 0.0f)
+                world[3] = glm::vec4(scattered(random), scattered(random), scattered(random), 1.0f);
+        }
+        instances.update(instanceBvh);
+        TV_CHECK(bvh.getCost() == rebuiltCost(bvh));
+        checkQueries(bvh, 20.0f * extent, random);
+
+        // a slot coming alive is not in the tree, which also forces a rebuild
+        instances.worlds[5] = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 3.0f));
+        instances.update(instanceBvh);
+        TV_CHECK(bvh.contains(5));
+        TV_CHECK(bvh.getCost() == rebuiltCost(bvh));
+        checkQueries(bvh, 20.0f * extent, random);
+    }
+}
+
+int main() {
+    testBvh(1000);
+    testBvh(tv::constants::config::SCENE_BVH_PARALLEL_CULL_MIN_IDS + 1000);
+    testInstanceBvh();
+    return 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// unlike assert it stays on in release builds, where the races the tests look for show up
+#define TV_CHECK(condition)                                                                         \
+    do {                                                                                            \
+        if (!(condition)) {                                                                         \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);     \
+            std::abort();                                                                           \
+        }                                                                                           \
+    } while (false)
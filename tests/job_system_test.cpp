@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "jobs/job_system.hpp"
+#include "jobs/work_stealing_deque.hpp"
+
+namespace {
+    constexpr std::size_t rounds = 64;
+
+    // every word of an item carries its id, so a torn copy does not pass as a real one
+    struct Item {
+        uint64_t id;
+        uint64_t check[4];
+    };
+
+    void testDequeUnderSteals() {
+        constexpr std::size_t itemCount = 1 << 18;
+        const std::size_t thiefCount = std::max<std::size_t>(2, std::thread::hardware_concurrency()) - 1;
+
+        // small enough for the owner to wrap around slots thieves are still reading
+        tv::WorkStealingDeque<Item> deque{ 8 };
+        std::vector<std::atomic<uint32_t>> taken(itemCount);
+        std::atomic<bool> ownerDone{ false };
+
+        const auto take = [&taken](const Item& item) {
+            for (const uint64_t word : item.check)
+                TV_CHECK(word == ~item.id);
+            TV_CHECK(item.id < itemCount);
+            taken[item.id].fetch_add(1, std::memory_order_relaxed);
+        };
+
+        std::vector<std::jthread> thieves;
+        for (std::size_t i = 0; i < thiefCount; ++i) {
+            thieves.emplace_back([&] {
+                Item item{};
+                while (!ownerDone.load(std::memory_order_acquire) || !deque.empty()) {
+                    if (deque.steal(item))
+                        take(item);
+                }
+            });
+        }
+
+        Item item{};
+        for (uint64_t id = 0; id < itemCount; ++id) {
+            while (!deque.push(Item{ id, { ~id, ~id, ~id, ~id } })) {
+                if (deque.pop(item))
+                    take(item);
+            }
+            if (id % 3 == 0 && deque.pop(item))
+                take(item);
+        }
+        while (deque.pop(item))
+            take(item);
+        ownerDone.store(true, std::memory_order_release);
+        thieves.clear();
+
+        for (const auto& count : taken)
+            TV_CHECK(count.load(std::memory_order_relaxed) == 1);
+    }
+
+    void testParallelFor(tv::JobSystem& jobSystem) {
+        std::vector<std::atomic<uint32_t>> hits(100000);
+        jobSystem.parallelFor(hits.size(), 97, [&hits](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+        for (const auto& hit : hits)
+            TV_CHECK(hit.load(std::memory_order_relaxed) == 1);
+
+        // nested ranges fill the deques past capacity and get stolen while the owner pushes
+        std::atomic<std::size_t> total{ 0 };
+        jobSystem.parallelFor(64, 1, [&jobSystem, &total](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                jobSystem.parallelFor(1000, 3, [&total](std::size_t first, std::size_t last) {
+                    total.fetch_add(last - first, std::memory_order_relaxed);
+                });
+            }
+        });
+        TV_CHECK(total.load() == 64 * 1000);
+    }
+
+    struct Chain {
+        std::atomic<std::size_t> first;
+        std::atomic<std::size_t> second;
+        std::atomic<bool> early;
+    };
+
+    void testRunAfter(tv::JobSystem& jobSystem) {
+        constexpr std::size_t firstCount = 200;
+        constexpr std::size_t secondCount = 50;
+
+        Chain chain{ 0, 0, false };
+        tv::JobCounter first;
+        tv::JobCounter second;
+        tv::JobCounter third;
+        for (std::size_t i = 0; i < firstCount; ++i) {
+            jobSystem.run(tv::Job{ [](void* data, std::size_t, std::size_t) {
+                static_cast<Chain*>(data)->first.fetch_add(1, std::memory_order_relaxed);
+            }, &chain, 0, 0, nullptr }, first);
+        }
+
+        // registered while the first jobs finish, so some continuations race the release
+        for (std::size_t i = 0; i < secondCount; ++i) {
+            jobSystem.runAfter(first, tv::Job{ [](void* data, std::size_t, std::size_t) {
+                Chain& chain = *static_cast<Chain*>(data);
+                if (chain.first.load(std::memory_order_relaxed) != firstCount)
+                    chain.early.store(true, std::memory_order_relaxed);
+                chain.second.fetch_add(1, std::memory_order_relaxed);
+            }, &chain, 0, 0, nullptr }, second);
+        }
+
+        jobSystem.runAfter(second, tv::Job{ [](void* data, std::size_t, std::size_t) {
+            Chain& chain = *static_cast<Chain*>(data);
+            if (chain.second.load(std::memory_order_relaxed) != secondCount)
+                chain.early.store(true, std::memory_order_relaxed);
+        }, &chain, 0, 0, nullptr }, third);
+
+        jobSystem.wait(third);
+        jobSystem.wait(second);
+        jobSystem.wait(first);
+        TV_CHECK(!chain.early.load());
+        TV_CHECK(chain.second.load() == secondCount);
+    }
+
+    void testForeignThreads(tv::JobSystem& jobSystem) {
+        // outside the pool jobs go through the injected queue
+        std::vector<std::jthread> threads;
+        for (std::size_t t = 0; t < 4; ++t) {
+            threads.emplace_back([&jobSystem] {
+                std::atomic<std::size_t> count{ 0 };
+                jobSystem.parallelFor(1000, 1, [&count](std::size_t begin, std::size_t end) {
+                    count.fetch_add(end - begin, std::memory_order_relaxed);
+                });
+                TV_CHECK(count.load() == 1000);
+            });
+        }
+    }
+}
+
+int main() {
+    testDequeUnderSteals();
+
+    tv::JobSystem& jobSystem = tv::JobSystem::instance();
+    for (std::size_t round = 0; round < rounds; ++round) {
+        testParallelFor(jobSystem);
+        testRunAfter(jobSystem);
+        testForeignThreads(jobSystem);
+    }
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "check.hpp"
+#include "render/memory_allocator.hpp"
+
+namespace {
+    constexpr vk::DeviceSize blockSize = 1 << 20;
+
+    constexpr uint32_t deviceLocalType = 0;
+    constexpr uint32_t coherentType = 1;
+    constexpr uint32_t cachedType = 2;
+
+    // device memory faked on the heap, so blocks can be counted and their mappings written
+    struct FakeDevice {
+        uint64_t nextMemory = 1;
+        std::map<uint64_t, std::unique_ptr<char[]>> live;
+        std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> invalidated;
+
+        tv::MemoryBlockCallbacks callbacks() {
+            tv::MemoryBlockCallbacks callbacks;
+            callbacks.allocate = [this](uint32_t, vk::DeviceSize size) {
+                const uint64_t memory = nextMemory++;
+                live[memory] = std::make_unique<char[]>(size);
+                return vk::DeviceMemory{ reinterpret_cast<VkDeviceMemory>(memory) };
+            };
+            callbacks.free = [this](vk::DeviceMemory memory) {
+                TV_CHECK(live.erase(key(memory)) == 1);
+            };
+            callbacks.map = [this](vk::DeviceMemory memory, vk::DeviceSize) -> void* {
+                return live.at(key(memory)).get();
+            };
+            callbacks.invalidate = [this](vk::DeviceMemory, vk::DeviceSize offset, vk::DeviceSize size) {
+                invalidated.emplace_back(offset, size);
+            };
+            return callbacks;
+        }
+
+        static uint64_t key(vk::DeviceMemory memory) {
+            return reinterpret_cast<uint64_t>(static_cast<VkDeviceMemory>(memory));
+        }
+    };
+
+    vk::PhysicalDeviceMemoryProperties memoryProperties() {
+        vk::PhysicalDeviceMemoryProperties properties{};
+        properties.memoryTypeCount = 3;
+        properties.memoryTypes[deviceLocalType].propertyFlags = vk::MemoryPropertyFlagBits::eDeviceLocal;
+        properties.memoryTypes[coherentType].propertyFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        properties.memoryTypes[cachedType].propertyFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached;
+        properties.memoryHeapCount = 1;
+        properties.memoryHeaps[0].size = 1ull << 32;
+        return properties;
+    }
+
+    vk::MemoryRequirements requirements(vk::DeviceSize size, vk::DeviceSize alignment) {
+        vk::MemoryRequirements requirements{};
+        requirements.size = size;
+        requirements.alignment = alignment;
+        requirements.memoryTypeBits = 0b111;
+        return requirements;
+    }
+
+    void checkDisjoint(const std::vector<tv::MemoryAllocation>& allocations) {
+        std::vector<const tv::MemoryAllocation*> sorted;
+        for (const auto& allocation : allocations)
+            sorted.push_back(&allocation);
+        std::ranges::sort(sorted, [](const auto* a, const auto* b) {
+            return FakeDevice::key(a->memory) != FakeDevice::key(b->memory) ? FakeDevice::key(a->memory) < FakeDevice::key(b->memory) : a->offset < b->offset;
+        });
+
+        for (std::size_t i = 1; i < sorted.size(); ++i) {
+            if (sorted[i - 1]->memory == sorted[i]->memory)
+                TV_CHECK(sorted[i - 1]->offset + sorted[i - 1]->size <= sorted[i]->offset);
+        }
+    }
+
+    void testEmptyBlocksAreReleased() {
+        FakeDevice device;
+        {
+            tv::MemoryAllocator allocator{ memoryProperties(), 1, device.callbacks(), blockSize };
+
+            // random sizes and alignments spill over several blocks
+            std::mt19937 random{ 7 };
+            std::uniform_int_distribution<vk::DeviceSize> size{ 1, blockSize / 8 };
+            std::uniform_int_distribution<int> alignmentShift{ 0, 12 };
+            std::vector<tv::MemoryAllocation> allocations;
+            for (int i = 0; i < 64; ++i) {
+                const vk::DeviceSize alignment = vk::DeviceSize{ 1 } << alignmentShift(random);
+                allocations.push_back(allocator.allocate(requirements(size(random), alignment), vk::MemoryPropertyFlagBits::eDeviceLocal, tv::AllocationTiling::linear));
+                TV_CHECK(allocations.back().block);
+                TV_CHECK(allocations.back().offset % alignment == 0);
+            }
+
+            checkDisjoint(allocations);
+            TV_CHECK(allocator.getStats().blockCount >= 3);
+            TV_CHECK(device.live.size() == allocator.getStats().blockCount);
+
+            std::ranges::shuffle(allocations, random);
+            for (auto& allocation : allocations)
+                allocator.free(allocation);
+
+            // one block stays for the next allocations of the type, every other one went back
+            const tv::MemoryAllocatorStats stats = allocator.getStats();
+            TV_CHECK(stats.blockCount == 1);
+            TV_CHECK(stats.blockBytes == blockSize);
+            TV_CHECK(stats.usedBytes == 0);
+            TV_CHECK(stats.wastedBytes == 0);
+            TV_CHECK(stats.allocationCount == 0);
+            TV_CHECK(device.live.size() == 1);
+
+            // the kept block merged back whole, so the largest node still fits without a new block
+            tv::MemoryAllocation half = allocator.allocate(requirements(blockSize / 2, 1), vk::MemoryPropertyFlagBits::eDeviceLocal, tv::AllocationTiling::linear);
+            TV_CHECK(half.block);
+            TV_CHECK(allocator.getStats().blockCount == 1);
+            allocator.free(half);
+        }
+
+        TV_CHECK(device.live.empty());
+    }
+
+    void testBlocksPerTypeAndTiling() {
+        FakeDevice device;
+        {
+            // a granularity above one keeps linear and optimal resources in separate blocks
+            tv::MemoryAllocator allocator{ memoryProperties(), 1024, device.callbacks(), blockSize };
+
+            std::vector<tv::MemoryAllocation> allocations;
+            for (int i = 0; i < 8; ++i) {
+                allocations.push_back(allocator.allocate(requirements(blockSize / 4, 256), vk::MemoryPropertyFlagBits::eDeviceLocal, tv::AllocationTiling::linear));
+                allocations.push_back(allocator.allocate(requirements(blockSize / 4, 256), vk::MemoryPropertyFlagBits::eDeviceLocal, tv::AllocationTiling::optimal));
+                allocations.push_back(allocator.allocate(requirements(blockSize / 4, 256), vk::MemoryPropertyFlagBits::eHostVisible, tv::AllocationTiling::linear));
+            }
+
+            for (const auto& allocation : allocations)
+                TV_CHECK(allocation.block);
+            checkDisjoint(allocations);
+            TV_CHECK(allocator.getStats().blockCount == 6);
+
+            for (auto& allocation : allocations)
+                allocator.free(allocation);
+            TV_CHECK(allocator.getStats().blockCount == 3);
+            TV_CHECK(device.live.size() == 3);
+        }
+
+        TV_CHECK(device.live.empty());
+    }
+
+    void testDedicated() {
+        FakeDevice device;
+        tv::MemoryAllocator allocator{ memoryProperties(), 1, device.callbacks(), blockSize };
+
+        tv::MemoryAllocation large = allocator.allocate(requirements(blockSize, 256), vk::MemoryPropertyFlagBits::eDeviceLocal, tv::AllocationTiling::optimal);
+        TV_CHECK(large.block);
+        TV_CHECK(large.offset == 0);
+        TV_CHECK(device.live.size() == 1);
+
+        allocator.free(large);
+        TV_CHECK(!large.block);
+        TV_CHECK(device.live.empty());
+        TV_CHECK(allocator.getStats().blockCount == 0);
+    }
+
+    void testInvalidate() {
+        FakeDevice device;
+        tv::MemoryAllocator allocator{ memoryProperties(), 1, device.callbacks(), blockSize };
+
+        tv::MemoryAllocation coherent = allocator.allocate(requirements(100, 4), vk::MemoryPropertyFlagBits::eHostVisible, tv::AllocationTiling::linear);
+        TV_CHECK(coherent.mapped);
+        allocator.invalidate(coherent);
+        TV_CHECK(device.invalidated.empty());
+
+        tv::MemoryAllocation device0 = allocator.allocate(requirements(100, 4), vk::MemoryPropertyFlagBits::eDeviceLocal, tv::AllocationTiling::linear);
+        TV_CHECK(!device0.mapped);
+        allocator.invalidate(device0);
+        TV_CHECK(device.invalidated.empty());
+
+        // non-coherent ranges start and end on multiples of the largest nonCoherentAtomSize
+        const tv::MemoryAllocation first = allocator.allocate(requirements(100, 4), vk::MemoryPropertyFlagBits::eHostCached, tv::AllocationTiling::linear);
+        TV_CHECK(first.block);
+        tv::MemoryAllocation cached = allocator.allocate(requirements(300, 4), vk::MemoryPropertyFlagBits::eHostCached, tv::AllocationTiling::linear);
+        TV_CHECK(cached.mapped);
+        allocator.invalidate(cached);
+        TV_CHECK(device.invalidated.size() == 1);
+        TV_CHECK(cached.offset != 0);
+        TV_CHECK(device.invalidated[0].first == cached.offset);
+        TV_CHECK(device.invalidated[0].first % 256 == 0);
+        TV_CHECK(device.invalidated[0].second == 512);
+
+        tv::MemoryAllocation dedicated = allocator.allocate(requirements(blockSize, 4), vk::MemoryPropertyFlagBits::eHostCached, tv::AllocationTiling::linear);
+        allocator.invalidate(dedicated);
+        TV_CHECK(device.invalidated.size() == 2);
+        TV_CHECK(device.invalidated[1].first == 0);
+        TV_CHECK(device.invalidated[1].second == VK_WHOLE_SIZE);
+    }
+}
+
+int main() {
+    testEmptyBlocksAreReleased();
+    testBlocksPerTypeAndTiling();
+    testDedicated();
+    testInvalidate();
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "check.hpp"
+#include "jobs/job_system.hpp"
+#include "render/pipeline_manager.hpp"
+
+namespace {
+    // the frame loop only ever updates the manager, it never waits on a handle
+    void testSingleWorker() {
+        tv::PipelineManager manager{ vk::Device{} };
+
+        int compiles = 0;
+        int fallbackCompiles = 0;
+        const tv::PipelineHandle fallback = manager.request([&fallbackCompiles] {
+            ++fallbackCompiles;
+            return vk::Pipeline{};
+        });
+        const tv::PipelineHandle handle = manager.request([&compiles] {
+            ++compiles;
+            return vk::Pipeline{};
+        }, fallback);
+
+        manager.update(0);
+        TV_CHECK(compiles == 1);
+        TV_CHECK(fallbackCompiles == 1);
+        TV_CHECK(!manager.isCompiling());
+
+        manager.rebuild(handle);
+        TV_CHECK(manager.isCompiling());
+        manager.update(1);
+        TV_CHECK(compiles == 2);
+        TV_CHECK(!manager.isCompiling());
+
+        // rebuilt again before the update, the finished compilation is outdated and compiled once more
+        manager.rebuild(handle);
+        manager.rebuild(handle);
+        manager.update(2);
+        TV_CHECK(compiles == 4);
+        TV_CHECK(manager.isCompiling());
+        manager.update(3);
+        TV_CHECK(!manager.isCompiling());
+        TV_CHECK(fallbackCompiles == 1);
+    }
+}
+
+int main() {
+    // no pool threads, the calling thread is the only worker
+    tv::JobSystem::setWorkerCount(1);
+    TV_CHECK(tv::JobSystem::instance().getWorkerCount() == 1);
+
+    testSingleWorker();
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "check.hpp"
+#include "scene/transform_kernel.hpp"
+
+namespace {
+    // counts around the SSE2 and AVX2 batch sizes, plus a large one that still ends in a tail
+    constexpr std::size_t counts[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 11, 12, 15, 16, 17, 23, 31, 33, 1027 };
+    constexpr std::size_t maxFirst = 5;
+    constexpr std::size_t objectCount = 1027 + maxFirst;
+
+    struct Transforms {
+        std::vector<float> values[10];
+
+        [[nodiscard]] tv::TransformArrays arrays() const {
+            return {
+                values[0].data(), values[1].data(), values[2].data(),
+                values[3].data(), values[4].data(), values[5].data(), values[6].data(),
+                values[7].data(), values[8].data(), values[9].data()
+            };
+        }
+    };
+
+    Transforms randomTransforms() {
+        std::mt19937 random{ 1234 };
+        std::uniform_real_distribution<float> position{ -100.0f, 100.0f };
+        std::uniform_real_distribution<float> unit{ -1.0f, 1.0f };
+        std::uniform_real_distribution<float> scale{ 0.1f, 10.0f };
+
+        Transforms transforms;
+        for (auto& values : transforms.values)
+            values.resize(objectCount);
+
+        for (std::size_t i = 0; i < objectCount; ++i) {
+            for (std::size_t axis = 0; axis < 3; ++axis) {
+                transforms.values[axis][i] = position(random);
+                transforms.values[7 + axis][i] = scale(random);
+            }
+
+            float rotation[4] = { unit(random), unit(random), unit(random), unit(random) };
+            const float length = std::sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2] + rotation[3] * rotation[3]);
+            for (std::size_t component = 0; component < 4; ++component)
+                transforms.values[3 + component][i] = length > 0.0f ? rotation[component] / length : (component == 3 ? 1.0f : 0.0f);
+        }
+
+        return transforms;
+    }
+
+    // the kernels sum the diagonal terms in a different order, so allow for rounding scaled by the largest scale
+    void checkClose(const glm::mat4& kernel, const glm::mat4& scalar) {
+        for (int column = 0; column < 4; ++column)
+            for (int row = 0; row < 4; ++row)
+                TV_CHECK(std::abs(kernel[column][row] - scalar[column][row]) <= 1e-5f * std::max(1.0f, std::abs(scalar[column][row])) + 1e-5f);
+    }
+
+    void testAgainstScalar(const Transforms& transforms) {
+        const tv::TransformArrays arrays = transforms.arrays();
+        for (std::size_t first = 0; first <= maxFirst; ++first) {
+            for (const std::size_t count : counts) {
+                // one guard matrix past the end catches writes beyond the last object
+                std::vector<glm::mat4> kernel(count + 1, glm::mat4{ -7.0f });
+                std::vector<glm::mat4> scalar(count);
+                tv::buildModelMatrices(arrays, first, first + count, kernel.data());
+                tv::buildModelMatricesScalar(arrays, first, first + count, scalar.data());
+
+                for (std::size_t i = 0; i < count; ++i)
+                    checkClose(kernel[i], scalar[i]);
+                TV_CHECK(kernel[count] == glm::mat4{ -7.0f });
+            }
+        }
+    }
+
+    void testStream(const Transforms& transforms) {
+        std::vector<glm::mat4> matrices(objectCount);
+        tv::buildModelMatricesScalar(transforms.arrays(), 0, objectCount, matrices.data());
+
+        // aligned output takes the non-temporal path, a float-offset output falls back to the copy
+        std::vector<float> out((objectCount + 1) * 16 + 1);
+        for (const std::size_t offset : { std::size_t{ 0 }, std::size_t{ 1 } }) {
+            auto* aligned = reinterpret_cast<float*>((reinterpret_cast<std::uintptr_t>(out.data()) + 31) & ~std::uintptr_t{ 31 });
+            auto* destination = reinterpret_cast<glm::mat4*>(aligned + offset);
+            for (const std::size_t count : counts) {
+                tv::streamModelMatrices(matrices.data(), count, destination);
+                TV_CHECK(std::memcmp(destination, matrices.data(), count * sizeof(glm::mat4)) == 0);
+            }
+        }
+    }
+}
+
+int main() {
+    const Transforms transforms = randomTransforms();
+    testAgainstScalar(transforms);
+    testStream(transforms);
+    return 0;
+}